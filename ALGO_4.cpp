@@ -1,298 +1,195 @@
 #include <bits/stdc++.h>
 #include <chrono>
-using namespace std;
-
-typedef long long ll;
-const ll INF = 1e18;
-
-// ------------------------ Flow Network (Dinic) ------------------------
-
-struct Edge {
-    int u, v;
-    ll cap, flow;
-    Edge(int u, int v, ll cap) : u(u), v(v), cap(cap), flow(0) {}
-};
-
-struct Dinic {
-    int n;
-    vector<Edge> edges;
-    vector<vector<int>> adj;
-    vector<int> level, ptr;
 
-    Dinic(int n) : n(n), adj(n) {}
+#include "dsd/dynamic.h"
+#include "dsd/graph.h"
+#include "dsd/io.h"
+#include "dsd/profile.h"
+#include "dsd/solver.h"
+using namespace std;
 
-    void add_edge(int u, int v, ll cap) {
-        adj[u].push_back(edges.size());
-        edges.emplace_back(u, v, cap);
-        adj[v].push_back(edges.size());
-        edges.emplace_back(v, u, 0);
-    }
+// ------------------------ Main CoreExact Algorithm ------------------------
+//
+// Command-line front end for CoreExact (Algorithm 4) and the approximations;
+// the searches live in dsd/core_exact.h, dsd/peel.h and dsd/frank_wolfe.h.
 
-    bool bfs(int s, int t) {
-        level.assign(n, -1);
-        queue<int> q;
-        level[s] = 0;
-        q.push(s);
+int main(int argc, char* argv[]) {
+    ios::sync_with_stdio(false);
+    cin.tie(0);
 
-        while (!q.empty()) {
-            int u = q.front(); q.pop();
-            for (int id : adj[u]) {
-                Edge& e = edges[id];
-                if (e.cap - e.flow > 0 && level[e.v] == -1) {
-                    level[e.v] = level[u] + 1;
-                    q.push(e.v);
-                }
-            }
+    dsd::SolverOptions opt;
+    opt.log = &cout;
+    string graph_file;
+    string profile_file;     // JSON phase/counter summary, "-" for stdout
+    bool trace = false;      // per-iteration records in the summary
+    string updates_file;     // "+ u v" / "- u v" lines to apply after solving
+    double tolerance = 0;    // re-solve once the bounds are this far apart
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--graph" && i + 1 < argc) {
+            graph_file = argv[++i];
+        } else if (arg == "--search" && i + 1 < argc) {
+            opt.search = argv[++i];
+        } else if (arg == "--search-width" && i + 1 < argc) {
+            opt.search_width = max(0, atoi(argv[++i]));
+        } else if (arg == "--cold-start") {
+            opt.cold_start = true;
+        } else if (arg == "--flow" && i + 1 < argc) {
+            opt.flow_engine = argv[++i];
+        } else if (arg == "--components") {
+            opt.components = true;
+        } else if (arg == "--approx") {
+            opt.algorithm = "approx";
+        } else if (arg == "--seed-approx") {
+            opt.seed_approx = true;
+        } else if (arg == "--passes" && i + 1 < argc) {
+            opt.passes = max(1, atoi(argv[++i]));
+        } else if (arg == "--frank-wolfe") {
+            opt.algorithm = "frank-wolfe";
+        } else if (arg == "--fw-iterations" && i + 1 < argc) {
+            opt.fw_iterations = max(0, atoi(argv[++i]));
+        } else if (arg == "--fw-gap" && i + 1 < argc) {
+            opt.fw_gap = atof(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            opt.threads = atoi(argv[++i]);
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profile_file = argv[++i];
+        } else if (arg == "--trace") {
+            trace = true;
+        } else if (arg == "--updates" && i + 1 < argc) {
+            updates_file = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = max(0.0, atof(argv[++i]));
+        } else if (arg == "--memory-budget" && i + 1 < argc) {
+            // Clique stores beyond this many MB are spilled to disk
+            opt.spill.memory_budget = (size_t)(max(0.0, atof(argv[++i])) * (1 << 20));
+        } else if (arg == "--spill-dir" && i + 1 < argc) {
+            opt.spill.dir = argv[++i];
+        } else if (arg == "--quiet") {
+            opt.verbose = false;
+        } else {
+            opt.h = atoi(argv[i]);
         }
-        return level[t] != -1;
     }
+    int h = opt.h;
 
-    ll dfs(int u, int t, ll pushed) {
-        if (u == t || pushed == 0) return pushed;
-        for (int& cid = ptr[u]; cid < (int)adj[u].size(); cid++) {
-            int id = adj[u][cid];
-            Edge& e = edges[id];
-            if (e.cap - e.flow > 0 && level[e.v] == level[u] + 1) {
-                ll tr = dfs(e.v, t, min(pushed, e.cap - e.flow));
-                if (tr == 0) continue;
-                e.flow += tr;
-                edges[id ^ 1].flow -= tr;
-                return tr;
-            }
-        }
-        return 0;
+    if (graph_file.empty()) {
+        cerr << "Usage: " << argv[0] << " <h> --graph FILE [--search dinkelbach|bisect] [--search-width K] [--flow dinic|push-relabel]"
+             << " [--components] [--seed-approx] [--approx] [--frank-wolfe]"
+             << " [--passes N] [--fw-iterations N] [--fw-gap X] [--cold-start] [--threads N]"
+             << " [--updates FILE] [--tolerance X] [--memory-budget MB] [--spill-dir DIR] [--profile FILE] [--trace] [--quiet]" << endl;
+        return 1;
     }
 
-    ll max_flow(int s, int t) {
-        ll flow = 0;
-        while (bfs(s, t)) {
-            ptr.assign(n, 0);
-            while (ll pushed = dfs(s, t, INF)) {
-                flow += pushed;
-            }
-        }
-        return flow;
+    string error = updates_file.empty() ? dsd::check_options(opt) : dsd::check_dynamic_options(opt);
+    if (!error.empty()) {
+        cerr << "Error: " << error << endl;
+        return 1;
     }
 
-    vector<int> min_cut(int s) {
-        vector<bool> visited(n, false);
-        queue<int> q;
-        q.push(s);
-        visited[s] = true;
+    if (!profile_file.empty()) dsd::profile::enable(trace);
 
-        while (!q.empty()) {
-            int u = q.front(); q.pop();
-            for (int id : adj[u]) {
-                Edge& e = edges[id];
-                if (e.cap - e.flow > 0 && !visited[e.v]) {
-                    visited[e.v] = true;
-                    q.push(e.v);
-                }
-            }
-        }
-
-        vector<int> cut;
-        for (int i = 0; i < n; i++) {
-            if (visited[i]) cut.push_back(i);
-        }
-        return cut;
+    dsd::profile::Scope load_phase("load");
+    dsd::Graph graph = dsd::read_graph(graph_file, opt.threads);
+    load_phase.stop();
+    if (graph.n == 0) {
+        cout << "Empty graph" << endl;
+        return 0;
     }
-};
 
-// ------------------------ Graph Utilities ------------------------
-
-vector<vector<int>> read_graph(const string& filename, int& n) {
-    ifstream file(filename);
-    int u, v;
-    vector<pair<int, int>> edges;
-    int max_node = 0;
-    while (file >> u >> v) {
-        edges.push_back({u, v});
-        max_node = max(max_node, max(u, v));
-    }
-    n = max_node + 1;
-    vector<vector<int>> adj(n);
-    for (auto& e : edges) {
-        if (e.first != e.second) {
-            adj[e.first].push_back(e.second);
-            adj[e.second].push_back(e.first);
+    if (!updates_file.empty()) {
+        // Dynamic mode: solve once, then maintain the answer under the updates
+        ifstream updates(updates_file);
+        if (!updates) {
+            cerr << "Error: Could not open file " << updates_file << endl;
+            return 1;
         }
-    }
-    return adj;
-}
 
-vector<int> read_core(const string& filename) {
-    ifstream file(filename);
-    int node, core;
-    vector<pair<int, int>> entries;
-    while (file >> node >> core) {
-        entries.push_back({node, core});
-    }
-    int max_node = 0;
-    for (auto& e : entries) max_node = max(max_node, e.first);
-    vector<int> core_number(max_node + 1, 0);
-    for (auto& e : entries) {
-        core_number[e.first] = e.second;
-    }
-    return core_number;
-}
-
-vector<set<int>> find_cliques(int h, const vector<vector<int>>& adj) {
-    vector<set<int>> cliques;
-    vector<int> temp;
-    function<void(int, int)> dfs = [&](int start, int depth) {
-        if (depth == h) {
-            cliques.push_back(set<int>(temp.begin(), temp.end()));
-            return;
-        }
-        for (int i = start; i < (int)adj.size(); i++) {
-            bool ok = true;
-            for (int v : temp) {
-                if (!binary_search(adj[v].begin(), adj[v].end(), i)) {
-                    ok = false;
-                    break;
-                }
-            }
-            if (ok) {
-                temp.push_back(i);
-                dfs(i + 1, depth + 1);
-                temp.pop_back();
+        auto start = chrono::high_resolution_clock::now();
+        dsd::DynamicDensest dynamic(graph, opt, tolerance);
+        chrono::duration<double> initial = chrono::high_resolution_clock::now() - start;
+        cout << "Initial density: " << fixed << setprecision(6) << dynamic.density() << endl;
+
+        long long applied = 0, ignored = 0;
+        start = chrono::high_resolution_clock::now();
+        string line;
+        while (getline(updates, line)) {
+            char op;
+            int u, v;
+            if (line.empty() || line[0] == '#' || sscanf(line.c_str(), " %c %d %d", &op, &u, &v) != 3) continue;
+            bool ok = op == '+' ? dynamic.insert_edge(u, v) : op == '-' ? dynamic.delete_edge(u, v) : false;
+            ok ? applied++ : ignored++;
+            if (ok && opt.verbose) {
+                cout << "Update " << applied << ": " << op << " " << u << " " << v << ", density " << dynamic.density()
+                     << " <= rho* <= " << dynamic.upper_bound() << endl;
             }
         }
-    };
-    dfs(0, 0);
-    return cliques;
-}
-
-// ------------------------ Main CoreExact Algorithm ------------------------
+        chrono::duration<double> streaming = chrono::high_resolution_clock::now() - start;
 
-int main(int argc, char* argv[]) {
-    ios::sync_with_stdio(false);
-    cin.tie(0);
-
-    int h = 3; // default
-    if (argc > 1) {
-        h = atoi(argv[1]);
-    }
-
-    int n;
-    auto adj = read_graph("as733_edges.txt", n);
-    auto core = read_core("core_as733.txt");
-
-    int kmax = *max_element(core.begin(), core.end());
-    cout << "kmax = " << kmax << endl;
-
-    set<int> core_vertices;
-    for (int i = 0; i < n; i++) {
-        if (core[i] == kmax) core_vertices.insert(i);
-    }
-
-    if (core_vertices.empty()) {
-        cout << "No vertices with core number kmax" << endl;
-        return 0;
-    }
-    auto start = chrono::high_resolution_clock::now();
-    // Induce subgraph
-    vector<int> mapping(n, -1);
-    vector<int> reverse_map;
-    int id = 0;
-    for (int v : core_vertices) {
-        mapping[v] = id++;
-        reverse_map.push_back(v);
-    }
-    vector<vector<int>> induced(id);
-    for (int u : core_vertices) {
-        for (int v : adj[u]) {
-            if (core_vertices.count(v)) {
-                induced[mapping[u]].push_back(mapping[v]);
-            }
+        // read_graph keeps file ids, so vertex ids are printed as they are
+        cout << "\nBest subgraph size: " << dynamic.vertices().size() << endl;
+        for (int v : dynamic.vertices()) {
+            cout << v << " ";
         }
-    }
-    for (auto& vec : induced) {
-        sort(vec.begin(), vec.end());
+        cout << endl;
+        cout << "Updates applied: " << applied << " (" << ignored << " ignored)" << endl;
+        cout << "Re-solves: " << dynamic.solves() - 1 << endl;
+        cout << "Number of " << h << "-cliques in the densest subgraph: " << dynamic.answer_cliques() << endl;
+        cout << "Maximum h-clique density: " << dynamic.density() << endl;
+        cout << "Upper bound on rho*: " << dynamic.upper_bound() << endl;
+        cout << "Initial solve time: " << initial.count() << " seconds." << endl;
+        cout << "Update time: " << streaming.count() << " seconds ("
+             << (applied ? streaming.count() / applied * 1e6 : 0) << " us per update)." << endl;
+        dsd::profile::write_json(profile_file);
+        return 0;
     }
 
-    // Find all h-cliques
-    auto h_cliques = find_cliques(h, induced);
-
-    if (h_cliques.empty()) {
+    dsd::SolverResult result = dsd::solve(graph, opt);
+    if (result.vertices.empty()) {
         cout << "No h-cliques found" << endl;
+        dsd::profile::write_json(profile_file);
         return 0;
     }
 
-    vector<int> degree(id, 0);
-    for (auto& clique : h_cliques) {
-        for (int v : clique) degree[v]++;
-    }
-
-    double l = 0, u = *max_element(degree.begin(), degree.end());
-    double eps = 1.0 / (id * id);
-
-    vector<int> best_subgraph;
-
-    while (u - l > eps) {
-        double alpha = (l + u) / 2;
+    vector<int> labels;
+    for (int v : result.vertices) labels.push_back(graph.label[v]);
+    sort(labels.begin(), labels.end());
 
-        Dinic dinic(id + 2);
-        int s = id, t = id + 1;
-
-        for (int v = 0; v < id; v++) {
-            dinic.add_edge(s, v, degree[v]);
-            dinic.add_edge(v, t, alpha * h);
+    if (opt.algorithm == "approx" || opt.algorithm == "frank-wolfe") {
+        cout << "\nApproximate subgraph size: " << labels.size() << endl;
+        for (int v : labels) {
+            cout << v << " ";
         }
-
-        for (auto& clique : h_cliques) {
-            for (int v : clique) {
-                for (int u : clique) {
-                    if (v != u) {
-                        dinic.add_edge(v, u, INF);
-                    }
-                }
-            }
+        cout << endl;
+        if (opt.algorithm == "approx") {
+            cout << "Peeling passes: " << result.stats.iterations << endl;
+        } else {
+            cout << "Frank-Wolfe iterations: " << result.stats.iterations << endl;
         }
-
-        ll flow = dinic.max_flow(s, t);
-
-        auto cut = dinic.min_cut(s);
-        if (cut.size() == 1) {
-            u = alpha;
+        cout << "Number of " << h << "-cliques in the subgraph: " << result.cliques << endl;
+        cout << "Approximate h-clique density: " << fixed << setprecision(6) << result.density << endl;
+        if (opt.algorithm == "approx") {
+            cout << "Guarantee: density >= rho*/" << h << ", so rho* <= " << result.stats.upper_bound << " (kmax = " << result.stats.kmax << ")" << endl;
         } else {
-            l = alpha;
-            best_subgraph.clear();
-            for (int v : cut) {
-                if (v < id) best_subgraph.push_back(v);
-            }
+            cout << "Upper bound on rho*: " << result.stats.upper_bound << endl;
         }
+        cout << "Time taken: " << result.stats.seconds << " seconds." << endl;
+        dsd::profile::write_json(profile_file);
+        return 0;
     }
 
-    cout << "\nBest subgraph size: " << best_subgraph.size() << endl;
-    for (int v : best_subgraph) {
-        cout << reverse_map[v] << " ";
+    cout << "\nBest subgraph size: " << labels.size() << endl;
+    for (int v : labels) {
+        cout << v << " ";
     }
     cout << endl;
 
-    set<int> subgraph_set(best_subgraph.begin(), best_subgraph.end());
-
-    int final_cliques = 0;
-    for (auto& clique : h_cliques) {
-        bool all_inside = true;
-        for (int v : clique) {
-            if (!subgraph_set.count(v)) {
-                all_inside = false;
-                break;
-            }
-        }
-        if (all_inside) final_cliques++;
-    }
-
-    auto end = chrono::high_resolution_clock::now();
-    chrono::duration<double> duration = end - start;
-
-    double density = 1.0 * final_cliques / best_subgraph.size();
-    cout << "Number of " << h << "-cliques in the densest subgraph: " << final_cliques << endl;
-    cout << "Maximum h-clique density: " << fixed << setprecision(6) << density << endl;
-    cout << "Time taken: " << duration.count() << " seconds." << endl;
+    cout << "Iterations: " << result.stats.iterations << endl;
+    cout << "Number of " << h << "-cliques in the densest subgraph: " << result.cliques << endl;
+    cout << "Maximum h-clique density: " << fixed << setprecision(6) << result.density << endl;
+    cout << "Time taken: " << result.stats.seconds << " seconds." << endl;
+    dsd::profile::write_json(profile_file);
 
     return 0;
 }
-
@@ -0,0 +1,402 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <string>
+#include <tuple>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "dsd/generate.h"
+
+using namespace std;
+
+// ------------------------ Benchmark Driver ------------------------
+//
+// Runs every (program, variant, dataset, h) combination --repeat times as a
+// child process and reports per-phase time percentiles, peak RSS and the
+// iteration count. Phases are read from the programs' own output: the
+// --profile summary line when the program prints one, plus every
+// "<phase> time: <x> ms|seconds" line, and the driver adds "wall" for the
+// whole process. With --check every program and variant must report the
+// same density for a dataset and h, so exact variants (say --search bisect
+// and dinkelbach) can be checked against each other. Synthetic datasets are generated with fixed
+// seeds into --data-dir the first time they are needed, so runs on different
+// machines or engines see identical inputs.
+
+struct Dataset {
+    string name;
+    string path;                    // real file, or where the generator writes
+    function<dsd::EdgeList()> make; // empty for real files
+};
+
+// Synthetic stand-ins for the datasets in the report: R-MAT graphs with
+// their vertex and edge counts, plus two unstructured controls.
+vector<Dataset> builtin_datasets() {
+    return {
+        {"netscience", "", [] { return dsd::rmat(1589, 2742, 0.45, 0.15, 0.15, 1); }},
+        {"as733", "", [] { return dsd::rmat(6474, 13895, 0.6, 0.15, 0.15, 2); }},
+        {"ca-hepth", "", [] { return dsd::rmat(9877, 25998, 0.5, 0.15, 0.15, 3); }},
+        {"wiki-vote", "", [] { return dsd::rmat(7115, 103689, 0.55, 0.2, 0.1, 4); }},
+        {"er", "", [] { return dsd::erdos_renyi(2000, 10000, 5); }},
+        {"planted", "", [] { return dsd::planted(2000, 8000, 40, 0.6, 6); }},
+    };
+}
+
+struct RunResult {
+    map<string, double> phase_ms;
+    map<string, long long> counters;
+    long peak_rss_kb = 0;
+    int iterations = 0;
+    string density;
+    bool ok = false;
+};
+
+struct Summary {
+    string program, variant, dataset;
+    int h;
+    map<string, vector<double>> phase_ms;
+    map<string, long long> counters; // from the last successful run
+    long peak_rss_kb = 0;
+    int iterations = 0;
+    string density;
+    int failures = 0;
+};
+
+vector<string> split(const string& s, char sep) {
+    vector<string> parts;
+    string part;
+    stringstream in(s);
+    while (getline(in, part, sep)) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+// "Core decomposition time: 0.25 seconds." -> {"core_decomposition", 250}
+bool parse_phase(const string& line, string& phase, double& ms) {
+    size_t colon = line.find(':');
+    if (colon == string::npos) return false;
+    string name = line.substr(0, colon);
+    for (char& c : name) c = tolower(c);
+    size_t at = name.find("time");
+    if (at == string::npos) return false;
+
+    const char* value = line.c_str() + colon + 1;
+    char* end;
+    ms = strtod(value, &end);
+    if (end == value) return false;
+    string unit = end;
+    if (unit.find("ms") != string::npos) {
+    } else if (unit.find("second") != string::npos) {
+        ms *= 1000;
+    } else {
+        return false;
+    }
+
+    name.erase(at, 4);
+    phase.clear();
+    for (const string& word : split(name, ' ')) {
+        if (word == "taken" || word == "execution") continue;
+        if (!phase.empty()) phase += '_';
+        phase += word;
+    }
+    if (phase.empty()) phase = "total";
+    return true;
+}
+
+// Reads `"name": <number>` entries of the object that starts at `key`, and
+// for nested objects the number after `field`.
+template <class Store>
+void parse_object(const string& line, const string& key, const string& field, Store store) {
+    size_t pos = line.find("\"" + key + "\": {");
+    if (pos == string::npos) return;
+    pos += key.size() + 5;
+    while (pos < line.size() && line[pos] == '"') {
+        size_t close = line.find('"', pos + 1);
+        string name = line.substr(pos + 1, close - pos - 1);
+        pos = close + 3; // past `": `
+        if (!field.empty()) {
+            pos = line.find("\"" + field + "\": ", pos) + field.size() + 4;
+            store(name, strtod(line.c_str() + pos, nullptr));
+            pos = line.find('}', pos) + 1;
+        } else {
+            char* end;
+            store(name, strtod(line.c_str() + pos, &end));
+            pos = end - line.c_str();
+        }
+        if (line.compare(pos, 2, ", ") == 0) pos += 2;
+    }
+}
+
+void parse_output(const string& output, RunResult& result) {
+    stringstream in(output);
+    string line;
+    while (getline(in, line)) {
+        string phase;
+        double ms;
+        if (line.rfind("{\"phases\": ", 0) == 0) {
+            parse_object(line, "phases", "seconds", [&](const string& name, double seconds) {
+                result.phase_ms[name] = seconds * 1000;
+            });
+            parse_object(line, "counters", "", [&](const string& name, double value) {
+                result.counters[name] = value;
+            });
+        } else if (parse_phase(line, phase, ms)) {
+            result.phase_ms[phase] += ms;
+        } else if (line.rfind("Iterations: ", 0) == 0) {
+            result.iterations = max(result.iterations, atoi(line.c_str() + 12));
+        } else if (line.rfind("Iteration ", 0) == 0) {
+            result.iterations = max(result.iterations, atoi(line.c_str() + 10));
+        } else if (line.rfind("Maximum h-clique density: ", 0) == 0) {
+            result.density = line.substr(26);
+        }
+    }
+}
+
+// Runs the program with its stdout captured; peak RSS comes from wait4.
+RunResult run(const string& program, const vector<string>& args, int timeout) {
+    RunResult result;
+    int pipefd[2];
+    if (pipe(pipefd) != 0) return result;
+
+    auto start = chrono::high_resolution_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) return result;
+    if (pid == 0) {
+        dup2(pipefd[1], STDOUT_FILENO);
+        close(pipefd[0]);
+        close(pipefd[1]);
+        if (timeout > 0) alarm(timeout);
+        vector<char*> argv;
+        argv.push_back((char*)program.c_str());
+        for (const string& a : args) argv.push_back((char*)a.c_str());
+        argv.push_back(nullptr);
+        execv(program.c_str(), argv.data());
+        _exit(127);
+    }
+
+    close(pipefd[1]);
+    string output;
+    char buffer[1 << 16];
+    ssize_t got;
+    while ((got = read(pipefd[0], buffer, sizeof(buffer))) > 0) output.append(buffer, got);
+    close(pipefd[0]);
+
+    int status;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    auto end = chrono::high_resolution_clock::now();
+
+    result.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    result.peak_rss_kb = usage.ru_maxrss;
+    parse_output(output, result);
+    result.phase_ms["wall"] = chrono::duration<double, milli>(end - start).count();
+    return result;
+}
+
+// Nearest-rank percentile of sorted values.
+double percentile(const vector<double>& sorted, double p) {
+    size_t rank = (size_t)max(0.0, ceil(p / 100 * sorted.size()) - 1);
+    return sorted[min(rank, sorted.size() - 1)];
+}
+
+void write_csv(ostream& out, const vector<Summary>& summaries) {
+    out << "program,variant,dataset,h,phase,runs,median_ms,p10_ms,p90_ms,min_ms,max_ms,peak_rss_kb,iterations,density,failures\n";
+    out << fixed << setprecision(3);
+    for (const Summary& s : summaries) {
+        for (auto [phase, times] : s.phase_ms) {
+            sort(times.begin(), times.end());
+            out << s.program << ',' << s.variant << ',' << s.dataset << ',' << s.h << ',' << phase << ','
+                << times.size() << ',' << percentile(times, 50) << ',' << percentile(times, 10) << ','
+                << percentile(times, 90) << ',' << times.front() << ',' << times.back() << ','
+                << s.peak_rss_kb << ',' << s.iterations << ',' << s.density << ',' << s.failures << '\n';
+        }
+    }
+}
+
+void write_json(ostream& out, const vector<Summary>& summaries) {
+    out << fixed << setprecision(3) << "[\n";
+    for (size_t i = 0; i < summaries.size(); i++) {
+        const Summary& s = summaries[i];
+        out << "  {\"program\": \"" << s.program << "\", \"variant\": \"" << s.variant << "\", \"dataset\": \""
+            << s.dataset << "\", \"h\": " << s.h << ", \"peak_rss_kb\": " << s.peak_rss_kb
+            << ", \"iterations\": " << s.iterations << ", \"density\": \"" << s.density
+            << "\", \"failures\": " << s.failures << ", \"counters\": {";
+        bool first = true;
+        for (const auto& [name, value] : s.counters) {
+            out << (first ? "" : ", ") << "\"" << name << "\": " << value;
+            first = false;
+        }
+        out << "}, \"phases\": {";
+        first = true;
+        for (auto [phase, times] : s.phase_ms) {
+            sort(times.begin(), times.end());
+            out << (first ? "" : ", ") << "\"" << phase << "\": {\"runs\": " << times.size()
+                << ", \"median_ms\": " << percentile(times, 50) << ", \"p10_ms\": " << percentile(times, 10)
+                << ", \"p90_ms\": " << percentile(times, 90) << ", \"min_ms\": " << times.front()
+                << ", \"max_ms\": " << times.back() << "}";
+            first = false;
+        }
+        out << "}}" << (i + 1 < summaries.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+int main(int argc, char* argv[]) {
+    vector<pair<string, string>> programs;
+    vector<pair<string, string>> variants;
+    vector<Dataset> datasets;
+    vector<string> dataset_names = {"netscience", "as733", "er", "planted"};
+    vector<int> hs = {3};
+    int repeat = 5;
+    int timeout = 0;
+    string data_dir = "bench_data";
+    string format = "csv";
+    string out_file;
+    bool check = false;
+
+    // NAME=VALUE options
+    auto named = [](const string& arg, pair<string, string>& out) {
+        size_t eq = arg.find('=');
+        if (eq == string::npos) return false;
+        out = {arg.substr(0, eq), arg.substr(eq + 1)};
+        return true;
+    };
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        pair<string, string> kv;
+        if (arg == "--program" && i + 1 < argc && named(argv[i + 1], kv)) {
+            programs.push_back(kv);
+            i++;
+        } else if (arg == "--variant" && i + 1 < argc && named(argv[i + 1], kv)) {
+            variants.push_back(kv);
+            i++;
+        } else if (arg == "--dataset" && i + 1 < argc && named(argv[i + 1], kv)) {
+            datasets.push_back({kv.first, kv.second, nullptr});
+            i++;
+        } else if (arg == "--datasets" && i + 1 < argc) {
+            dataset_names = split(argv[++i], ',');
+        } else if (arg == "--h" && i + 1 < argc) {
+            hs.clear();
+            for (const string& h : split(argv[++i], ',')) hs.push_back(atoi(h.c_str()));
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = max(1, atoi(argv[++i]));
+        } else if (arg == "--timeout" && i + 1 < argc) {
+            timeout = max(0, atoi(argv[++i]));
+        } else if (arg == "--data-dir" && i + 1 < argc) {
+            data_dir = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc) {
+            format = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            out_file = argv[++i];
+        } else if (arg == "--check") {
+            check = true;
+        } else {
+            cerr << "Error: unknown argument " << arg << endl;
+            return 1;
+        }
+    }
+
+    if (format != "csv" && format != "json") {
+        cerr << "Error: unknown format " << format << " (use csv or json)" << endl;
+        return 1;
+    }
+    if (programs.empty()) programs = {{"algo1", "./algo1"}, {"algo4", "./algo4"}};
+    if (variants.empty()) variants = {{"default", ""}};
+
+    // Built-in datasets named with --datasets, generated on first use
+    vector<Dataset> builtin = builtin_datasets();
+    for (const string& name : dataset_names) {
+        auto it = find_if(builtin.begin(), builtin.end(), [&](const Dataset& d) { return d.name == name; });
+        if (it == builtin.end()) {
+            cerr << "Error: unknown dataset " << name << endl;
+            return 1;
+        }
+        Dataset d = *it;
+        d.path = data_dir + "/" + d.name + ".txt";
+        datasets.push_back(d);
+    }
+    mkdir(data_dir.c_str(), 0755);
+    for (const Dataset& d : datasets) {
+        struct stat st;
+        if (!d.make || stat(d.path.c_str(), &st) == 0) continue;
+        cerr << "Generating " << d.path << endl;
+        if (!dsd::write_edge_list(d.path, d.make())) {
+            cerr << "Error: could not write " << d.path << endl;
+            return 1;
+        }
+    }
+
+    vector<Summary> summaries;
+    for (const auto& [program, path] : programs) {
+        for (const auto& [variant, extra] : variants) {
+            for (const Dataset& d : datasets) {
+                for (int h : hs) {
+                    Summary s{};
+                    s.program = program;
+                    s.variant = variant;
+                    s.dataset = d.name;
+                    s.h = h;
+                    vector<string> args = {to_string(h), "--graph", d.path, "--profile", "-", "--quiet"};
+                    for (const string& a : split(extra, ' ')) args.push_back(a);
+
+                    for (int r = 0; r < repeat; r++) {
+                        RunResult result = run(path, args, timeout);
+                        if (!result.ok) {
+                            s.failures++;
+                            continue;
+                        }
+                        for (const auto& [phase, ms] : result.phase_ms) s.phase_ms[phase].push_back(ms);
+                        s.peak_rss_kb = max(s.peak_rss_kb, result.peak_rss_kb);
+                        s.iterations = result.iterations;
+                        s.counters = result.counters;
+                        s.density = result.density;
+                    }
+                    cerr << program << " " << variant << " " << d.name << " h=" << h << ": "
+                         << repeat - s.failures << "/" << repeat << " runs ok" << endl;
+                    summaries.push_back(s);
+                }
+            }
+        }
+    }
+
+    ofstream file;
+    if (!out_file.empty()) file.open(out_file);
+    ostream& out = out_file.empty() ? cout : file;
+    if (format == "csv") {
+        write_csv(out, summaries);
+    } else {
+        write_json(out, summaries);
+    }
+
+    // Densities are compared as printed, against the first run of the same
+    // dataset and h
+    int mismatches = 0;
+    if (check) {
+        map<tuple<string, int>, const Summary*> reference;
+        for (const Summary& s : summaries) {
+            if (s.density.empty()) continue;
+            auto [it, inserted] = reference.emplace(make_tuple(s.dataset, s.h), &s);
+            const Summary& r = *it->second;
+            if (inserted || r.density == s.density) continue;
+            cerr << "Mismatch on " << s.dataset << " h=" << s.h << ": " << r.program << " " << r.variant << " found "
+                 << r.density << ", " << s.program << " " << s.variant << " found " << s.density << endl;
+            mismatches++;
+        }
+        cerr << "Check: " << mismatches << " mismatches" << endl;
+    }
+    return mismatches ? 2 : 0;
+}
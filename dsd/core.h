@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+#include "kclist.h"
+#include "parallel.h"
+#include "peel.h"
+
+namespace dsd {
+
+// ------------------------ k-Core Decomposition ------------------------
+
+// Linear-time bucket peeling (Batagelj-Zaversnik).
+inline std::vector<int> core_numbers(const Graph& g) {
+    int degeneracy;
+    std::vector<int> core;
+    degeneracy_order(g, degeneracy, &core);
+    return core;
+}
+
+// Level-synchronous parallel peeling (PKC). At level k every thread first
+// collects its own vertices of remaining degree k, then all threads peel
+// their frontiers concurrently; a neighbor whose degree drops to k joins the
+// frontier of the thread that dropped it.
+inline std::vector<int> parallel_core_numbers(const Graph& g, int threads = 0) {
+    int n = g.n;
+    threads = std::max(1, std::min(resolve_threads(threads), n));
+    if (threads == 1) return core_numbers(g);
+
+    std::vector<int> core(n, 0);
+    std::vector<std::atomic<int>> deg(n);
+    for (int v = 0; v < n; v++) deg[v].store(g.degree(v), std::memory_order_relaxed);
+
+    std::atomic<long long> peeled(0);
+    Barrier barrier(threads);
+    run_threads(threads, [&](int tid) {
+        int begin = (long long)n * tid / threads, end = (long long)n * (tid + 1) / threads;
+        std::vector<int> frontier;
+        for (int level = 0; ; level++) {
+            frontier.clear();
+            for (int v = begin; v < end; v++) {
+                if (deg[v].load(std::memory_order_relaxed) == level) frontier.push_back(v);
+            }
+            barrier.wait();
+
+            for (size_t i = 0; i < frontier.size(); i++) {
+                int v = frontier[i];
+                core[v] = level;
+                for (int u : g.neighbors(v)) {
+                    if (deg[u].load(std::memory_order_relaxed) <= level) continue;
+                    int before = deg[u].fetch_sub(1, std::memory_order_relaxed);
+                    if (before == level + 1) {
+                        frontier.push_back(u);
+                    } else if (before <= level) {
+                        deg[u].fetch_add(1, std::memory_order_relaxed); // lost a race, undo
+                    }
+                }
+            }
+            peeled.fetch_add(frontier.size(), std::memory_order_relaxed);
+            barrier.wait();
+            // Safe to read: no thread adds to `peeled` before the next scan barrier
+            if (peeled.load(std::memory_order_relaxed) == n) break;
+        }
+    });
+    return core;
+}
+
+// ------------------------ h-Clique-Core Decomposition ------------------------
+//
+// The (k,Ψ)-core is the largest subgraph in which every vertex lies in at
+// least k h-cliques. Peeling the vertex of minimum clique degree and
+// decrementing the other members of every clique it still belongs to yields
+// each vertex's clique-core number. Clique degrees are unbounded, so this
+// is the radix-heap peel of peel.h rather than a bucket array.
+inline std::vector<long long> clique_core_numbers(const Graph& g, int h, std::vector<long long> deg) {
+    return peel_cliques(g, h, std::move(deg)).core;
+}
+
+inline std::vector<long long> clique_core_numbers(const Graph& g, int h, int threads = 1) {
+    std::vector<long long> deg;
+    clique_degrees(CliqueLister(g), h, deg, threads);
+    return clique_core_numbers(g, h, std::move(deg));
+}
+
+} // namespace dsd
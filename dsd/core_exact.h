@@ -0,0 +1,403 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <memory>
+#include <numeric>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+#include "exact.h"
+#include "flow.h"
+#include "graph.h"
+#include "kclist.h"
+#include "parallel.h"
+#include "peel.h"
+#include "profile.h"
+
+namespace dsd {
+
+// ------------------------ CoreExact Search ------------------------
+//
+// Search for the h-clique densest subgraph among `vertices`, given their
+// (k,Ψ)-core numbers and bounds l <= rho* <= u. The densest subgraph D lies
+// in the (⌈ρ*⌉,Ψ)-core (removing any vertex of D must not raise its density,
+// so each lies in at least ρ* cliques of D), hence in the (⌈l⌉,Ψ)-core for
+// every lower bound l: whenever l improves past the current threshold the
+// network is rebuilt on that smaller core. `witness` is returned if no cut
+// ever beats it.
+//
+// With all capacities scaled by q and the sink arcs at h*p, the minimum cut
+// has a non-empty source side S exactly when some S has density above p/q,
+// and then S maximizes cliques(S) - (p/q)|S|.
+//
+// dinkelbach: start from p/q = density of the witness and jump to the
+//             density of each cut found; the first empty cut proves the
+//             current set optimal. The probes sit on the grid of
+//             bisection_scale just above p/q, so the sink arcs only rise and
+//             one network keeps its flow until the core shrinks; when the
+//             grid is too fine, every iteration builds a network scaled by
+//             q instead. Usually only a handful of flows.
+// bisect:     the binary search on the grid of bisection_scale, fixed by
+//             the first core (and the witness) so it stays fine enough as
+//             the core shrinks, with one network warm-started across
+//             iterations. It starts just below the witness's density and
+//             falls back to dinkelbach when the grid is too fine.
+
+inline SearchResult core_exact(const Graph& graph, const std::vector<ll>& core, const std::vector<int>& vertices,
+                               double l, double u, std::vector<int> witness, const SearchOptions& opt) {
+    int h = opt.h;
+    SearchResult result;
+    result.vertices = std::move(witness);
+
+    // Search state for the current (threshold,Ψ)-core, renumbered along its
+    // degeneracy order
+    ll threshold = 0;
+    Graph induced;
+    int id = 0;
+    std::vector<int> ids; // vertex v of `induced` is vertex ids[v] of `graph`
+    std::vector<ll> degree;
+    CliqueStore h_cliques(h);
+
+    auto locate_core = [&](ll k) {
+        profile::Scope phase("clique_listing");
+        threshold = k;
+        std::vector<int> core_vertices;
+        for (int v : vertices) {
+            if (core[v] >= k) core_vertices.push_back(v);
+        }
+        Graph sub = induced_subgraph(graph, core_vertices);
+        int degeneracy;
+        std::vector<int> order = degeneracy_order(sub, degeneracy);
+        induced = relabel(sub, order);
+        id = induced.n;
+        ids.resize(id);
+        for (int v = 0; v < id; v++) ids[v] = core_vertices[order[v]];
+
+        // Find all h-cliques into a flat buffer, counting degrees on the fly
+        h_cliques = collect_cliques(CliqueLister(induced), h, &degree, opt.threads, opt.spill);
+    };
+
+    // `add` runs twice per build: once to count arcs, once to write them.
+    // One node per h-clique C with v -> C (cap 1) and C -> v (cap h-1) for
+    // its members, i.e. 2h arcs per clique.
+    int s = 0, t = 0;
+    ll scale = 1; // q; every finite capacity but the sink arcs is scaled by it
+    std::vector<long long> sink_arcs;
+    auto add = [&](auto& net) {
+        sink_arcs.clear();
+        for (int v = 0; v < id; v++) {
+            net.add_edge(s, v, degree[v] * scale);
+            sink_arcs.push_back(net.add_sink_edge(v, t, 0));
+        }
+
+        for (size_t c = 0; c < h_cliques.size(); c++) {
+            const int* clique = h_cliques[c];
+            int cn = id + 2 + c;
+            for (int i = 0; i < h; i++) {
+                net.add_edge(clique[i], cn, scale);
+                net.add_edge(cn, clique[i], (h - 1) * scale);
+            }
+        }
+    };
+    auto build_network = [&](ll cap_bound) {
+        profile::Scope phase("network_build");
+        s = id;
+        t = id + 1;
+        int num_nodes = id + 2 + h_cliques.size();
+        auto network = build_max_flow(opt.flow_engine, num_nodes, cap_bound, add);
+        h_cliques.release();
+        return network;
+    };
+
+    // Source side of a cut as ids of `graph`
+    auto cut_vertices = [&](const std::vector<int>& cut) {
+        std::vector<int> side;
+        for (int v : cut) {
+            if (v < id) side.push_back(ids[v]);
+        }
+        return side;
+    };
+
+    ll p = count_cliques(CliqueLister(induced_subgraph(graph, result.vertices)), h, opt.threads);
+    ll q = result.vertices.size();
+    auto ceil_density = [&]() { return q ? (p + q - 1) / q : 0; };
+
+    if (opt.search == "dinkelbach") {
+        locate_core(std::max<ll>({1, (ll)std::ceil(l), ceil_density()}));
+        if (opt.log && opt.verbose) {
+            *opt.log << "Searching the (" << threshold << ",Ψ)-core: " << id << " vertices, " << h_cliques.size() << " h-cliques" << std::endl;
+        }
+
+        // The grid is fixed by the first core, as in the bisection
+        ll grid = h_cliques.empty() ? 0 : bisection_scale(std::max<ll>(id, q), h_cliques.size(), u, h);
+        std::unique_ptr<MaxFlow> network;
+        while (!h_cliques.empty()) {
+            result.iterations++;
+
+            // Sink arcs at h*a over the current scale, just above p/q on the grid
+            ll a = !grid ? p : q ? grid_floor(p, q, grid) + 1 : 1;
+            if (!network || !grid || opt.cold_start) {
+                scale = grid ? grid : std::max<ll>(q, 1);
+                network = build_network(grid ? h * ((ll)std::ceil((long double)u * grid) + 1) : h * p);
+            }
+            profile::Scope flow_phase("max_flow");
+            network->set_sink_capacity(sink_arcs, h * a, s, t);
+            network->max_flow(s, t);
+            auto cut = network->min_cut(s);
+            flow_phase.stop();
+            profile::trace({{"iteration", (double)result.iterations}, {"alpha", (double)p / q},
+                                 {"flow", (double)network->outflow(s)}, {"cut_nodes", (double)cut.size() - 1}});
+            if (cut.size() == 1) break; // nothing denser than p/q
+
+            // Density of the cut side, from the cliques of the current core
+            profile::Scope verify_phase("verification");
+            std::vector<char> inside(id, 0);
+            for (int v : cut) {
+                if (v < id) inside[v] = 1;
+            }
+            ll cliques = 0;
+            for (size_t c = 0; c < h_cliques.size(); c++) {
+                const int* clique = h_cliques[c];
+                bool all = true;
+                for (int i = 0; i < h && all; i++) all = inside[clique[i]];
+                cliques += all;
+            }
+            result.vertices = cut_vertices(cut);
+            p = cliques;
+            q = result.vertices.size();
+            verify_phase.stop();
+            if (opt.log && opt.verbose) {
+                *opt.log << "Iteration " << result.iterations << ": density " << p << "/" << q << std::endl;
+            }
+
+            // A better lower bound may exclude more of the graph
+            if (ceil_density() > threshold) {
+                locate_core(ceil_density());
+                network.reset();
+                if (opt.log && opt.verbose) {
+                    *opt.log << "Shrinking to the (" << threshold << ",Ψ)-core: " << id << " vertices, " << h_cliques.size() << " h-cliques" << std::endl;
+                }
+            }
+        }
+        return result;
+    }
+
+    // Bisection over alpha = a / grid: the networks (one per probe) are
+    // rebuilt only when the core shrinks; otherwise only the v -> t
+    // capacities follow alpha
+    locate_core(std::max<ll>(1, std::ceil(l)));
+    if (h_cliques.empty()) return result;
+    ll grid = bisection_scale(std::max<ll>(id, q), h_cliques.size(), u, h);
+    if (grid == 0) {
+        if (opt.log) *opt.log << "Bisection grid too fine for 64-bit capacities, using Dinkelbach" << std::endl;
+        SearchOptions dinkelbach = opt;
+        dinkelbach.search = "dinkelbach";
+        return core_exact(graph, core, vertices, l, u, std::move(result.vertices), dinkelbach);
+    }
+
+    // The witness is denser than lo / grid, and nothing beats up / grid
+    ll lo = q ? grid_floor(p, q, grid) - 1 : 0;
+    ll up = (ll)std::ceil((long double)u * grid);
+    scale = grid;
+    std::vector<std::unique_ptr<MaxFlow>> networks(search_width(opt));
+    auto build_networks = [&]() {
+        for (auto& network : networks) network = build_network(h * up);
+    };
+    build_networks();
+    if (opt.log && opt.verbose) {
+        *opt.log << "Searching the (" << threshold << ",Ψ)-core: " << id << " vertices, " << h_cliques.size() << " h-cliques" << std::endl;
+    }
+
+    while (up - lo > 1) {
+        result.iterations++;
+
+        // Warm start: reuse the previous flow, repairing only the sink arcs
+        if (opt.cold_start) build_networks();
+        profile::Scope flow_phase("max_flow");
+        std::vector<Probe> probes = probe_alphas(networks, lo, up, sink_arcs, h, s, t);
+        flow_phase.stop();
+
+        ll old_lo = lo;
+        for (Probe& probe : probes) {
+            profile::trace({{"iteration", (double)result.iterations}, {"alpha", (double)probe.alpha / grid},
+                                 {"flow", (double)probe.flow}, {"cut_nodes", (double)probe.cut.size() - 1}});
+            if (probe.cut.size() == 1) {
+                up = std::min(up, probe.alpha);
+            } else if (probe.alpha > lo && probe.alpha < up) {
+                lo = probe.alpha;
+                result.vertices = cut_vertices(probe.cut);
+            }
+        }
+
+        // A better lower bound may exclude more of the graph: the optimum is
+        // above lo / grid, so it lies in the (lo / grid + 1,Ψ)-core
+        if (lo > old_lo && lo / grid + 1 > threshold) {
+            locate_core(lo / grid + 1);
+            build_networks();
+            if (opt.log && opt.verbose) {
+                *opt.log << "Shrinking to the (" << threshold << ",Ψ)-core: " << id << " vertices, " << h_cliques.size() << " h-cliques" << std::endl;
+            }
+        }
+    }
+    return result;
+}
+
+// ------------------------ CoreExact (Algorithm 4) ------------------------
+//
+// (k,Ψ)-core decomposition first: every vertex of the (kmax,Ψ)-core lies in
+// kmax of its h-cliques, so it has density at least kmax/h, and no subgraph
+// can beat kmax. The search then starts from those bounds.
+//
+// components: the densest subgraph is connected, so it lies in one component
+//             of the (⌈kmax/h⌉,Ψ)-core. A component whose own kmax can't
+//             beat the best density found so far is skipped; the others are
+//             solved concurrently, largest first, each on one thread.
+// seed_approx: a peeling answer can only raise the starting lower bound, and
+//             is kept if the search doesn't beat it.
+
+inline SearchResult core_exact_densest(const Graph& graph, const SearchOptions& opt) {
+    int h = opt.h;
+    int n = graph.n;
+    int threads = resolve_threads(opt.threads);
+    SearchResult best;
+    if (n == 0) return best;
+
+    // (k,Ψ)-core decomposition of h-cliques; for h = 2 these are the k-cores.
+    // With seed_approx the peel that finds the seed yields them too.
+    auto core_start = std::chrono::high_resolution_clock::now();
+    profile::Scope core_phase("core_decomposition");
+    std::vector<ll> core(n);
+    PeelResult seed;
+    if (opt.seed_approx) {
+        seed = peel_densest(graph, h, opt.passes, threads);
+        core = std::move(seed.core);
+    } else if (h == 2) {
+        std::vector<int> k_core = parallel_core_numbers(graph, threads);
+        std::copy(k_core.begin(), k_core.end(), core.begin());
+    } else {
+        core = clique_core_numbers(graph, h, threads);
+    }
+    core_phase.stop();
+    std::chrono::duration<double> core_duration = std::chrono::high_resolution_clock::now() - core_start;
+
+    ll kmax = *std::max_element(core.begin(), core.end());
+    best.kmax = kmax;
+    if (opt.log) {
+        *opt.log << "kmax = " << kmax << std::endl;
+        *opt.log << "Core decomposition time: " << core_duration.count() << " seconds." << std::endl;
+    }
+    if (kmax == 0) return best;
+
+    double lower = (double)kmax / h;
+
+    if (opt.seed_approx && opt.log) {
+        *opt.log << "Peeling lower bound: " << seed.density << " (" << seed.passes << " passes)" << std::endl;
+    }
+
+    SearchOptions inner = opt;
+    inner.threads = threads;
+
+    if (!opt.components) {
+        std::vector<int> all(n), witness;
+        std::iota(all.begin(), all.end(), 0);
+        for (int v = 0; v < n; v++) {
+            if (core[v] == kmax) witness.push_back(v);
+        }
+        if (seed.density > lower) {
+            lower = seed.density;
+            witness = seed.vertices;
+        }
+        SearchResult result = core_exact(graph, core, all, lower, kmax, witness, inner);
+        best.vertices = std::move(result.vertices);
+        best.iterations = result.iterations;
+
+        // Never report less than the peeling answer
+        if (opt.seed_approx) {
+            ll cliques = count_cliques(CliqueLister(induced_subgraph(graph, best.vertices)), h, threads);
+            if ((double)cliques / best.vertices.size() < seed.density) best.vertices = seed.vertices;
+        }
+        std::sort(best.vertices.begin(), best.vertices.end());
+        return best;
+    }
+
+    std::vector<int> part;
+    for (int v = 0; v < n; v++) {
+        if (core[v] >= (ll)std::ceil(lower)) part.push_back(v);
+    }
+    Graph bearing = induced_subgraph(graph, part);
+    int count;
+    std::vector<int> comp = connected_components(bearing, count);
+
+    std::vector<std::vector<int>> members(count);
+    std::vector<ll> comp_kmax(count, 0);
+    for (int i = 0; i < bearing.n; i++) {
+        int v = part[i];
+        members[comp[i]].push_back(v);
+        comp_kmax[comp[i]] = std::max(comp_kmax[comp[i]], core[v]);
+    }
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return members[a].size() > members[b].size(); });
+
+    inner.verbose = false;
+    inner.threads = count > 1 ? 1 : threads;
+
+    // Best exact density so far; ties go to the earlier component in `order`
+    std::mutex mu;
+    double best_density = 0;
+    long long best_rank = count;
+    if (opt.seed_approx) {
+        // The seed wins ties
+        best_density = seed.density;
+        best_rank = -1;
+        best.vertices = seed.vertices;
+    }
+    std::atomic<int> pruned(0);
+    std::atomic<int> total_iterations(0);
+
+    parallel_for(count, threads, 1, [&](long long begin, long long end, int) {
+        for (long long rank = begin; rank < end; rank++) {
+            int c = order[rank];
+            double l;
+            {
+                std::lock_guard<std::mutex> lock(mu);
+                if (comp_kmax[c] < best_density || (comp_kmax[c] == best_density && best_rank < rank)) {
+                    pruned++;
+                    continue;
+                }
+                l = std::max((double)comp_kmax[c] / h, best_density);
+            }
+
+            std::vector<int> witness;
+            for (int v : members[c]) {
+                if (core[v] == comp_kmax[c]) witness.push_back(v);
+            }
+            SearchResult result = core_exact(graph, core, members[c], l, comp_kmax[c], witness, inner);
+            total_iterations += result.iterations;
+
+            ll cliques = count_cliques(CliqueLister(induced_subgraph(graph, result.vertices)), h);
+            double density = (double)cliques / result.vertices.size();
+            std::lock_guard<std::mutex> lock(mu);
+            if (density > best_density || (density == best_density && rank < best_rank)) {
+                best_density = density;
+                best_rank = rank;
+                best.vertices = std::move(result.vertices);
+            }
+        }
+    });
+
+    best.iterations = total_iterations;
+    best.components = count;
+    best.pruned = pruned;
+    if (opt.log) *opt.log << "Components: " << count << " (" << pruned << " pruned)" << std::endl;
+    std::sort(best.vertices.begin(), best.vertices.end());
+    return best;
+}
+
+} // namespace dsd
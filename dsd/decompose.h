@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "exact.h"
+#include "flow.h"
+#include "graph.h"
+#include "kclist.h"
+#include "profile.h"
+
+namespace dsd {
+
+// ------------------------ Locally-Dense Decomposition ------------------------
+//
+// The chain {} = B0 ⊂ B1 ⊂ ... ⊂ Bk = V in which every Bi is the largest set
+// B ⊃ B(i-1) maximizing (c(B) - c(B(i-1))) / (|B| - |B(i-1)|), where c counts
+// the h-cliques inside a set (Tatti and Gionis). The ratios strictly
+// decrease, so the levels Bi \ B(i-1) rank the vertices from the densest
+// region outward; B1 is the largest densest subgraph.
+//
+// Each level builds the Algorithm 1 network once for the vertices left: the
+// region found so far is contracted into s (INF source arcs, no sink arcs)
+// and the (h-1)-cliques inside it are dropped, so the network shrinks as
+// the region grows. The minimum cut at alpha then trades c(S) against
+// alpha * |S \ B(i-1)| over the sets S containing the region, which is the
+// ratio above. Capacities are scaled by m^2 for the m vertices left (the
+// grid of bisection_scale), and only the sink arcs move between probes,
+// warm-started with set_sink_capacity.
+//
+// Dinkelbach on the grid: from a ratio p/q it probes the first grid point
+// above it, and a non-empty cut is a set with a higher ratio. Distinct
+// ratios of sets of at most m vertices differ by more than one grid step,
+// so an empty cut proves p/q is the level's ratio, and one more probe at
+// the last grid point below p/q has Bi as its only minimum cut. The clique
+// degrees, the (h-1)-cliques and their extensions are listed once for all
+// levels.
+//
+// When the grid doesn't fit in 64-bit capacities, every iteration builds
+// the network instead, scaled by q with the sink arcs at h*p, and Bi is the
+// largest minimum cut at the level's final p/q.
+
+struct DenseLevel {
+    std::vector<int> vertices; // added at this level, sorted ids of the input graph
+    long long cliques = 0;     // h-cliques gained: c(Bi) - c(B(i-1))
+    double density = 0;        // cliques / vertices.size()
+    int iterations = 0;        // max-flow calls
+};
+
+// The levels from the densest outward, at most `max_levels` of them (0 for
+// all). Vertices in no h-clique end up in a last level of density 0.
+inline std::vector<DenseLevel> locally_dense_decomposition(const Graph& input, const SearchOptions& opt,
+                                                           int max_levels = 0) {
+    int h = opt.h;
+    int threads = opt.threads;
+    std::vector<DenseLevel> levels;
+    auto log = [&](bool every_iteration) -> std::ostream* {
+        return opt.log && (opt.verbose || !every_iteration) ? opt.log : nullptr;
+    };
+
+    profile::Scope load_phase("relabel");
+    int degeneracy;
+    std::vector<int> order = degeneracy_order(input, degeneracy);
+    Graph graph = relabel(input, order);
+    int n_vertices = graph.n;
+    load_phase.stop();
+    if (n_vertices == 0) return levels;
+
+    profile::Scope listing_phase("clique_listing");
+    CliqueLister lister(graph);
+    std::vector<ll> clique_degrees;
+    ll total = dsd::clique_degrees(lister, h, clique_degrees, threads);
+    CliqueStore h_minus_1_cliques = collect_cliques(lister, h - 1, nullptr, threads, opt.spill);
+    CliqueExtensions extensions = clique_extensions(graph, h_minus_1_cliques, threads);
+    listing_phase.stop();
+    if (auto out = log(false)) {
+        *out << "Found " << total << " " << h << "-cliques and " << h_minus_1_cliques.size() << " " << (h - 1)
+             << "-cliques" << std::endl;
+    }
+
+    // Nodes: s, the vertices, the (h-1)-cliques, t
+    int s = 0;
+    int first_clique = n_vertices + 1;
+    int t = first_clique + h_minus_1_cliques.size();
+    int num_nodes = t + 1;
+
+    ll max_degree = *std::max_element(clique_degrees.begin(), clique_degrees.end());
+    bool warned = false;
+
+    // The region B(i-1) found so far, and the (h-1)-cliques inside it
+    std::vector<char> in_region(n_vertices, 0);
+    std::vector<char> contracted(h_minus_1_cliques.size(), 0);
+    int region_size = 0;
+    ll region_cliques = 0;
+
+    // As in exact_search, with the region contracted into s
+    ll scale = 1;
+    std::vector<long long> sink_arcs;
+    auto add = [&](auto& net) {
+        sink_arcs.clear();
+        for (int i = 0; i < n_vertices; ++i) {
+            if (in_region[i]) {
+                net.add_edge(s, i + 1, INF);
+            } else {
+                net.add_edge(s, i + 1, clique_degrees[i] * scale);
+                sink_arcs.push_back(net.add_sink_edge(i + 1, t, 0));
+            }
+        }
+
+        for (size_t i = 0; i < h_minus_1_cliques.size(); ++i) {
+            if (contracted[i]) continue;
+            const int* clique = h_minus_1_cliques[i];
+            for (int j = 0; j < h_minus_1_cliques.k; j++) {
+                net.add_edge(first_clique + i, clique[j] + 1, INF);
+            }
+            for (int v : extensions[i]) {
+                net.add_edge(v + 1, first_clique + i, scale);
+            }
+        }
+    };
+    std::unique_ptr<MaxFlow> network;
+    auto build = [&](ll cap_bound) {
+        profile::Scope build_phase("network_build");
+        network = build_max_flow(opt.flow_engine, num_nodes, cap_bound, add);
+        h_minus_1_cliques.release();
+    };
+
+    // Vertices of a cut side outside the region, as ids of `graph`
+    auto new_vertices = [&](const std::vector<int>& cut) {
+        std::vector<int> side;
+        for (int node : cut) {
+            if (node >= 1 && node <= n_vertices && !in_region[node - 1]) side.push_back(node - 1);
+        }
+        return side;
+    };
+
+    // h-cliques inside the region extended by `added`
+    auto cliques_with = [&](const std::vector<int>& added) {
+        if (region_size + (int)added.size() == n_vertices) return total;
+        std::vector<int> set = added;
+        for (int v = 0; v < n_vertices; v++) {
+            if (in_region[v]) set.push_back(v);
+        }
+        return count_cliques(CliqueLister(induced_subgraph(graph, set)), h, threads);
+    };
+
+    // New vertices of the minimum cut with the sink arcs at h*a, where
+    // alpha = a / scale
+    auto probe = [&](DenseLevel& level, ll a) {
+        level.iterations++;
+        profile::Scope flow_phase("max_flow");
+        network->set_sink_capacity(sink_arcs, h * a, s, t);
+        network->max_flow(s, t);
+        std::vector<int> cut = new_vertices(network->min_cut(s));
+        flow_phase.stop();
+        if (auto out = log(true)) {
+            *out << "Level " << levels.size() + 1 << ", iteration " << level.iterations << ": alpha = " << (double)a / scale
+                 << ", cut adds " << cut.size() << " vertices" << std::endl;
+        }
+        profile::trace({{"level", (double)levels.size() + 1}, {"iteration", (double)level.iterations},
+                        {"alpha", (double)a / scale}, {"cut_nodes", (double)cut.size()}});
+        return cut;
+    };
+
+    while (region_size < n_vertices && (max_levels <= 0 || (int)levels.size() < max_levels)) {
+        DenseLevel level;
+        std::vector<int> added;
+        ll gained;
+
+        if (region_cliques == total) {
+            // Nothing left gains a clique
+            for (int v = 0; v < n_vertices; v++) {
+                if (!in_region[v]) added.push_back(v);
+            }
+            gained = 0;
+        } else {
+            // Dinkelbach on the gain ratio, from everything outside the region
+            ll p = total - region_cliques, q = n_vertices - region_size;
+            ll grid = bisection_scale(q, total, max_degree, h);
+            if (grid) {
+                scale = grid;
+                build(h * (max_degree * grid + 1));
+            } else if (!warned) {
+                warned = true;
+                if (auto out = log(false)) *out << "Grid too fine for 64-bit capacities, rebuilding per iteration" << std::endl;
+            }
+            while (true) {
+                if (!grid) {
+                    scale = q;
+                    build(h * p);
+                }
+                std::vector<int> cut = probe(level, grid ? p * grid / q + 1 : p);
+                if (cut.empty()) break;
+
+                profile::Scope verify_phase("verification");
+                p = cliques_with(cut) - region_cliques;
+                q = cut.size();
+            }
+
+            if (grid) {
+                // p/q is the level's ratio; just below it Bi is the only minimum cut
+                added = probe(level, (p * grid + q - 1) / q - 1);
+            } else {
+                // Every set reaching p/q is on the source side of the largest
+                // minimum cut, which is Bi
+                added = new_vertices(network->max_cut(t));
+            }
+            profile::Scope verify_phase("verification");
+            gained = cliques_with(added) - region_cliques;
+        }
+
+        for (int v : added) in_region[v] = 1;
+        region_size += added.size();
+        region_cliques += gained;
+        for (size_t i = 0; i < h_minus_1_cliques.size(); ++i) {
+            if (contracted[i]) continue;
+            const int* clique = h_minus_1_cliques[i];
+            contracted[i] = std::all_of(clique, clique + h_minus_1_cliques.k, [&](int v) { return in_region[v]; });
+        }
+
+        level.cliques = gained;
+        level.density = (double)gained / added.size();
+        for (int v : added) level.vertices.push_back(order[v]);
+        std::sort(level.vertices.begin(), level.vertices.end());
+        if (auto out = log(false)) {
+            *out << "Level " << levels.size() + 1 << ": " << added.size() << " vertices, density " << gained << "/"
+                 << added.size() << std::endl;
+        }
+        levels.push_back(std::move(level));
+    }
+    return levels;
+}
+
+} // namespace dsd
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+#include "intersect.h"
+#include "kclist.h"
+#include "profile.h"
+#include "solver.h"
+
+namespace dsd {
+
+// ------------------------ Dynamic Maintenance ------------------------
+//
+// Keeps the densest subgraph of a graph under edge insertions and deletions.
+// The h-cliques an update creates or destroys are exactly the cliques that
+// contain both endpoints, i.e. the (h-2)-cliques of N(u) ∩ N(v), so every
+// update lists only those and adjusts the clique degrees, the total and the
+// clique count of the current answer S. Its cost is the size of that local
+// neighborhood, not of the graph.
+//
+// The answer is certified by density(S) <= ρ* <= upper. An insertion that
+// creates Δ cliques raises any set's clique count by at most Δ, and a set
+// containing a new clique has at least h vertices, so ρ* grows by at most
+// Δ/h; a deletion never raises ρ*. The flow search only re-runs when the
+// bounds drift further apart than the relative `tolerance` (0: whenever S
+// is no longer provably optimal), on a snapshot of the current graph.
+
+// The bounds only meet when each re-solve is exact; the approximations
+// leave a gap that would trigger a re-solve on every update.
+inline std::string check_dynamic_options(const SolverOptions& opt) {
+    std::string error = check_options(opt);
+    if (!error.empty()) return error;
+    if (opt.algorithm != "exact" && opt.algorithm != "core-exact") {
+        return "dynamic updates need an exact algorithm (exact or core-exact), not " + opt.algorithm;
+    }
+    return "";
+}
+
+struct DynamicDensest {
+    // Initial graph, h and the settings for re-solving, which should pass
+    // check_dynamic_options; ids are vertex ids of `g`, and updates may add
+    // new ones.
+    DynamicDensest(const Graph& g, const SolverOptions& opt, double tolerance = 0)
+        : opt(opt), tolerance(tolerance), h(opt.h), adj(g.n) {
+        for (int v = 0; v < g.n; v++) adj[v].assign(g.neighbors(v).begin(), g.neighbors(v).end());
+        total = clique_degrees(CliqueLister(g), h, degree, resolve_threads(opt.threads));
+        in_answer.assign(g.n, 0);
+        resolve();
+    }
+
+    int num_vertices() const { return adj.size(); }
+    long long num_cliques() const { return total; }
+    long long clique_degree(int v) const { return v < (int)degree.size() ? degree[v] : 0; }
+    const std::vector<int>& vertices() const { return answer; }
+    long long answer_cliques() const { return cliques; }
+    double density() const { return answer.empty() ? 0 : (double)cliques / answer.size(); }
+    double upper_bound() const { return upper; }
+    int solves() const { return num_solves; }
+
+    // Both return false (and change nothing) for self-loops, negative ids,
+    // existing edges on insert and missing edges on delete.
+    bool insert_edge(int u, int v) {
+        if (u == v || u < 0 || v < 0) return false;
+        grow(std::max(u, v) + 1);
+        if (has_edge(u, v)) return false;
+        adj[u].insert(std::lower_bound(adj[u].begin(), adj[u].end(), v), v);
+        adj[v].insert(std::lower_bound(adj[v].begin(), adj[v].end(), u), u);
+        long long created = update_cliques(u, v, +1);
+        upper += (double)created / h;
+        check();
+        return true;
+    }
+
+    bool delete_edge(int u, int v) {
+        if (u == v || u < 0 || v < 0 || std::max(u, v) >= num_vertices() || !has_edge(u, v)) return false;
+        update_cliques(u, v, -1);
+        adj[u].erase(std::lower_bound(adj[u].begin(), adj[u].end(), v));
+        adj[v].erase(std::lower_bound(adj[v].begin(), adj[v].end(), u));
+        check();
+        return true;
+    }
+
+    // Snapshot of the current graph in CSR form.
+    Graph graph() const {
+        std::vector<std::pair<int, int>> edges;
+        for (int v = 0; v < num_vertices(); v++) {
+            for (int u : adj[v]) {
+                if (v < u) edges.push_back({v, u});
+            }
+        }
+        return build_graph(num_vertices(), edges);
+    }
+
+private:
+    SolverOptions opt;
+    double tolerance;
+    int h;
+    std::vector<std::vector<int>> adj; // sorted neighbor lists
+    std::vector<long long> degree;     // h-cliques containing each vertex
+    long long total = 0;               // h-cliques in the graph
+    std::vector<int> answer;           // S, sorted
+    std::vector<char> in_answer;
+    long long cliques = 0;             // h-cliques inside S
+    double upper = 0;
+    int num_solves = 0;
+
+    bool has_edge(int u, int v) const { return std::binary_search(adj[u].begin(), adj[u].end(), v); }
+
+    void grow(int n) {
+        if (n <= num_vertices()) return;
+        adj.resize(n);
+        degree.resize(n, 0);
+        in_answer.resize(n, 0);
+    }
+
+    // Adds `sign` to every clique containing the edge (u, v); returns how
+    // many there are.
+    long long update_cliques(int u, int v, int sign) {
+        profile::Scope phase("local_update");
+        std::vector<int> clique(h);
+        clique[0] = u;
+        clique[1] = v;
+        long long found = 0;
+        auto visit = [&]() {
+            found++;
+            bool inside = true;
+            for (int w : clique) {
+                degree[w] += sign;
+                inside = inside && in_answer[w];
+            }
+            if (inside) cliques += sign;
+        };
+
+        if (h == 2) {
+            visit();
+        } else {
+            // cand[d]: common neighbors of clique[0..d), larger than clique[d-1]
+            // for d > 2
+            std::vector<std::vector<int>> cand(h);
+            cand[2].resize(std::min(adj[u].size(), adj[v].size()));
+            int len = intersect(adj[u].data(), adj[u].size(), adj[v].data(), adj[v].size(), cand[2].data());
+            for (int d = 3; d < h; d++) cand[d].resize(len);
+
+            auto extend = [&](auto& self, int depth, int len) -> void {
+                const int* cur = cand[depth].data();
+                if (depth == h - 1) {
+                    for (int i = 0; i < len; i++) {
+                        clique[depth] = cur[i];
+                        visit();
+                    }
+                    return;
+                }
+                int need = h - depth - 1;
+                for (int i = 0; i + need < len; i++) {
+                    int w = cur[i];
+                    const std::vector<int>& nw = adj[w];
+                    int skip = std::upper_bound(nw.begin(), nw.end(), w) - nw.begin();
+                    int m = intersect(cur + i + 1, len - i - 1, nw.data() + skip, nw.size() - skip, cand[depth + 1].data());
+                    if (m < need) continue;
+                    clique[depth] = w;
+                    self(self, depth + 1, m);
+                }
+            };
+            extend(extend, 2, len);
+        }
+        total += sign * found;
+        profile::count(profile::CLIQUES_LISTED, found);
+        return found;
+    }
+
+    // The slack absorbs rounding in the running sum `upper`
+    void check() {
+        if (upper > density() * (1 + tolerance) + 1e-9) resolve();
+    }
+
+    // Full flow search on a snapshot; resets both bounds.
+    void resolve() {
+        num_solves++;
+        SolverOptions quiet = opt;
+        quiet.log = nullptr;
+        SolverResult result = solve(graph(), quiet);
+        answer = result.vertices;
+        cliques = result.cliques;
+        upper = std::max(result.stats.upper_bound, density());
+        std::fill(in_answer.begin(), in_answer.end(), 0);
+        for (int v : answer) in_answer[v] = 1;
+        if (opt.log && opt.verbose) {
+            *opt.log << "Re-solved: " << answer.size() << " vertices, density " << density() << std::endl;
+        }
+    }
+};
+
+} // namespace dsd
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "flow.h"
+#include "graph.h"
+#include "kclist.h"
+#include "parallel.h"
+#include "profile.h"
+
+namespace dsd {
+
+// Settings shared by the flow-based searches.
+struct SearchOptions {
+    int h = 3;
+    std::string search = "dinkelbach";   // or "bisect"
+    bool cold_start = false;             // re-solve every max-flow from zero
+    std::string flow_engine = "dinic";   // or "push-relabel"
+    bool components = false;             // solve components separately (core-exact only)
+    bool seed_approx = false;            // start from the peeling answer (core-exact only)
+    int passes = 1;                      // peeling passes for seed_approx
+    int search_width = 1;                // bisect: alphas probed per round (0: one per thread)
+    int threads = 1;                     // for clique listing inside one search
+    SpillPolicy spill;                   // clique stores beyond a memory budget go to disk
+    std::ostream* log = nullptr;         // progress lines; null for silent
+    bool verbose = true;                 // also log every iteration
+};
+
+struct SearchResult {
+    std::vector<int> vertices; // ids of the searched graph
+    int iterations = 0;
+    long long kmax = 0;        // largest (k,Ψ)-core number (core-exact only)
+    int components = 0;        // components searched and pruned (core-exact
+    int pruned = 0;            // with components only)
+};
+
+// ---- Exact grid ----
+//
+// The searches run on the grid of alphas a / scale with scale = n^2 for a
+// search over n vertices: finite capacities are scaled by it and the sink
+// arcs get h*a, so every probe is integral. Two distinct densities of sets
+// of at most n vertices differ by at least 1/(n(n-1)), more than one grid
+// step, so an empty cut one grid step above a known density, or bisection
+// bounds one step apart, prove an optimum. The scale is refused when the scaled capacities could
+// come near INF: the source and clique arcs add up to at most
+// h(h+1) * cliques * scale, and no sink arc goes above h * upper * scale
+// for a density bound `upper`. The flow itself is bounded by the source
+// arcs.
+
+inline ll bisection_scale(ll vertices, ll cliques, double upper, int h) {
+    long double scale = (long double)vertices * vertices;
+    long double total = scale * h * ((long double)(h + 1) * cliques + upper + 1);
+    return total < (long double)INF / 4 ? (ll)scale : 0;
+}
+
+// floor(p * scale / q) without forming p * scale, for p/q within the bounds
+// of bisection_scale
+inline ll grid_floor(ll p, ll q, ll scale) {
+    return p / q * scale + (ll)((long double)(p % q) * scale / q);
+}
+
+// ---- Speculative k-ary bisection ----
+//
+// A bisection round tests one alpha and waits for its max-flow. With a search
+// width k > 1 a round tests k alphas spread evenly over (l, u) instead, each
+// on its own copy of the network and its own thread; the copies are built
+// from the same read-only clique data, and each warm-starts from its own
+// previous flow. Cuts are monotone in alpha, so the largest alpha with a
+// non-empty cut and the smallest with an empty one are the new bounds, and
+// the interval shrinks by k + 1 per round instead of 2.
+
+struct Probe {
+    ll alpha = 0; // numerator over the bisection scale
+    ll flow = 0;
+    std::vector<int> cut; // source side of the minimum cut
+};
+
+inline int search_width(const SearchOptions& opt) {
+    return opt.search_width > 0 ? opt.search_width : resolve_threads(opt.threads);
+}
+
+// One round on networks.size() copies, in increasing alpha, for grid bounds
+// with u - l >= 2; a single probe tests the midpoint.
+inline std::vector<Probe> probe_alphas(std::vector<std::unique_ptr<MaxFlow>>& networks, ll l, ll u,
+                                       const std::vector<long long>& sink_arcs, int h, int s, int t) {
+    int k = networks.size();
+    std::vector<Probe> probes(k);
+    run_threads(k, [&](int j) {
+        Probe& probe = probes[j];
+        ll step = k == 1 ? (u - l) / 2 : (ll)((long double)(u - l) * (j + 1) / (k + 1));
+        probe.alpha = std::min(std::max(l + step, l + 1), u - 1);
+        MaxFlow& network = *networks[j];
+        network.set_sink_capacity(sink_arcs, h * probe.alpha, s, t);
+        network.max_flow(s, t);
+        probe.flow = network.outflow(s);
+        probe.cut = network.min_cut(s);
+    });
+    return probes;
+}
+
+// ------------------------ Exact Method (Algorithm 1) ------------------------
+//
+// Goldberg's construction generalized to h-cliques: s -> v with capacity
+// the clique degree of v, v -> t with capacity alpha*h, an INF arc from every
+// (h-1)-clique node to its members and a unit arc from every vertex v to each
+// (h-1)-clique that v extends to an h-clique. The minimum cut has a non-empty
+// source side exactly when some subgraph is denser than alpha.
+//
+// dinkelbach: from the density p/q of the current set, probe the first grid
+//             point above it. A non-empty cut is strictly denser and gives
+//             the next p/q; an empty cut proves p/q optimal. p/q only grows,
+//             so the sink arcs only rise and one network keeps its flow
+//             across iterations. When the grid is too fine for the
+//             capacities, each iteration builds a network scaled by q with
+//             the sink arcs at h*p instead, again with no rounding.
+// bisect:     the binary search on the grid, with one network warm-started
+//             across iterations; it falls back to dinkelbach when the grid
+//             is too fine for the capacities.
+
+// The search itself, on cliques listed beforehand: `graph` is already in
+// degeneracy order, clique_degrees[v] counts the h-cliques at v and
+// h_minus_1_cliques holds every (h-1)-clique. Vertices are ids of `graph`.
+inline SearchResult exact_search(const Graph& graph, const std::vector<ll>& clique_degrees, ll num_h_cliques,
+                                 const CliqueStore& h_minus_1_cliques, const SearchOptions& opt) {
+    int h = opt.h;
+    int threads = opt.threads;
+    int n_vertices = graph.n;
+    SearchResult result;
+    auto log = [&](bool every_iteration) -> std::ostream* {
+        return opt.log && (opt.verbose || !every_iteration) ? opt.log : nullptr;
+    };
+    if (num_h_cliques == 0) return result;
+
+    // Common neighbors of every (h-1)-clique: the vertices that extend it to
+    // an h-clique. They don't depend on alpha, so they are computed once.
+    profile::Scope listing_phase("clique_listing");
+    CliqueExtensions extensions = clique_extensions(graph, h_minus_1_cliques, threads);
+    listing_phase.stop();
+
+    // Nodes: s, the vertices, the (h-1)-cliques, t
+    int s = 0;
+    int first_clique = n_vertices + 1;
+    int t = first_clique + h_minus_1_cliques.size();
+    int num_nodes = t + 1;
+
+    // Arcs are counted in a first pass and written in a second, so `add`
+    // runs twice. Finite capacities other than the sink arcs are scaled by
+    // `scale`, so a rational alpha = p/q becomes integral: scale q, sink h*p.
+    ll scale = 1;
+    std::vector<long long> sink_arcs;
+    auto add = [&](auto& net) {
+        // Source to vertices, and vertices to sink (capacity alpha * h, set per iteration)
+        sink_arcs.clear();
+        for (int i = 0; i < n_vertices; ++i) {
+            net.add_edge(s, i + 1, clique_degrees[i] * scale);
+        }
+        for (int i = 0; i < n_vertices; ++i) {
+            sink_arcs.push_back(net.add_sink_edge(i + 1, t, 0));
+        }
+
+        // (h-1)-cliques to their members
+        for (size_t i = 0; i < h_minus_1_cliques.size(); ++i) {
+            const int* clique = h_minus_1_cliques[i];
+            for (int j = 0; j < h_minus_1_cliques.k; j++) {
+                net.add_edge(first_clique + i, clique[j] + 1, INF);
+            }
+        }
+
+        // Vertices to the (h-1)-cliques they extend
+        for (size_t i = 0; i < h_minus_1_cliques.size(); ++i) {
+            for (int v : extensions[i]) {
+                net.add_edge(v + 1, first_clique + i, scale);
+            }
+        }
+    };
+
+    // Vertices on the source side of a cut, as ids of `graph`
+    auto cut_vertices = [&](const std::vector<int>& cut) {
+        std::vector<int> side;
+        for (int node : cut) {
+            if (node >= 1 && node <= n_vertices) side.push_back(node - 1);
+        }
+        return side;
+    };
+
+    std::vector<int> best_subgraph;
+    int& iteration = result.iterations;
+    ll max_degree = *std::max_element(clique_degrees.begin(), clique_degrees.end());
+    ll grid = bisection_scale(n_vertices, num_h_cliques, max_degree, h);
+    if (opt.search == "bisect" && grid == 0) {
+        if (auto out = log(false)) *out << "Bisection grid too fine for 64-bit capacities, using Dinkelbach" << std::endl;
+    }
+    if (opt.search == "dinkelbach" || grid == 0) {
+        ll p = num_h_cliques, q = n_vertices;
+        for (int i = 0; i < n_vertices; ++i) best_subgraph.push_back(i);
+        if (auto out = log(false)) *out << "Starting Dinkelbach search from density " << p << "/" << q << std::endl;
+
+        std::unique_ptr<MaxFlow> network;
+        while (true) {
+            iteration++;
+
+            // Sink arcs at h*a over the current scale, just above p/q on the grid
+            ll a = grid ? grid_floor(p, q, grid) + 1 : p;
+            if (!network || !grid || opt.cold_start) {
+                scale = grid ? grid : q;
+                profile::Scope build_phase("network_build");
+                network = build_max_flow(opt.flow_engine, num_nodes, grid ? h * (max_degree * grid + 1) : h * p, add);
+                h_minus_1_cliques.release();
+            }
+
+            // Compute max flow and min cut
+            profile::Scope flow_phase("max_flow");
+            network->set_sink_capacity(sink_arcs, h * a, s, t);
+            network->max_flow(s, t);
+            ll flow = network->outflow(s);
+            std::vector<int> cut = network->min_cut(s);
+            flow_phase.stop();
+            if (auto out = log(true)) *out << "Iteration " << iteration << ": alpha = " << p << "/" << q << ", max flow: " << flow << std::endl;
+            profile::trace({{"iteration", (double)iteration}, {"alpha", (double)p / q}, {"flow", (double)flow},
+                            {"cut_nodes", (double)cut.size() - 1}});
+
+            if (cut.size() == 1 && cut[0] == s) {
+                if (auto out = log(true)) *out << "Empty cut, density " << p << "/" << q << " is optimal" << std::endl;
+                break;
+            }
+
+            profile::Scope verify_phase("verification");
+            best_subgraph = cut_vertices(cut);
+            p = count_cliques(CliqueLister(induced_subgraph(graph, best_subgraph)), h, threads);
+            q = best_subgraph.size();
+            verify_phase.stop();
+            if (auto out = log(true)) *out << "Non-empty cut with " << q << " vertices, density " << p << "/" << q << std::endl;
+        }
+    } else {
+        // Binary search for densest subgraph over alpha = a / grid. The whole
+        // graph is denser than l = 0, and no subgraph beats the largest
+        // clique degree.
+        ll l = 0, u = max_degree * grid;
+        for (int i = 0; i < n_vertices; ++i) best_subgraph.push_back(i);
+        if (auto out = log(false)) *out << "Starting binary search with bounds [0, " << max_degree << "] in steps of 1/" << grid << std::endl;
+
+        // Build the flow network once per probe; only the sink capacities
+        // depend on alpha
+        scale = grid;
+        std::vector<std::unique_ptr<MaxFlow>> networks(search_width(opt));
+        auto build_networks = [&]() {
+            profile::Scope build_phase("network_build");
+            for (auto& network : networks) network = build_max_flow(opt.flow_engine, num_nodes, h * u, add);
+            h_minus_1_cliques.release();
+        };
+        build_networks();
+
+        while (u - l > 1) {
+            iteration++;
+
+            // Warm start from the previous iteration's flow unless asked not to
+            if (opt.cold_start) build_networks();
+
+            // Compute max flows and min cuts
+            profile::Scope flow_phase("max_flow");
+            std::vector<Probe> probes = probe_alphas(networks, l, u, sink_arcs, h, s, t);
+            flow_phase.stop();
+
+            for (Probe& probe : probes) {
+                double alpha = (double)probe.alpha / grid;
+                if (auto out = log(true)) *out << "Iteration " << iteration << ": alpha = " << alpha << std::endl;
+                if (auto out = log(true)) *out << "Max flow: " << probe.flow << std::endl;
+                profile::trace({{"iteration", (double)iteration}, {"alpha", alpha}, {"flow", (double)probe.flow},
+                                {"cut_nodes", (double)probe.cut.size() - 1}});
+
+                if (probe.cut.size() == 1 && probe.cut[0] == s) {
+                    if (probe.alpha >= u) continue;
+                    u = probe.alpha;
+                    if (auto out = log(true)) *out << "Empty cut, updating upper bound to " << alpha << std::endl;
+                } else if (probe.alpha > l && probe.alpha < u) {
+                    l = probe.alpha;
+                    best_subgraph = cut_vertices(probe.cut);
+                    if (auto out = log(true)) *out << "Non-empty cut with " << best_subgraph.size() << " vertices, updating lower bound to " << alpha << std::endl;
+                }
+            }
+        }
+    }
+
+    result.vertices = std::move(best_subgraph);
+    return result;
+}
+
+inline SearchResult exact_densest(const Graph& input, const SearchOptions& opt) {
+    int h = opt.h;
+    int threads = opt.threads;
+    SearchResult result;
+    std::ostream* out = opt.log;
+
+    // Renumber along the degeneracy order for locality; vertex v of `graph`
+    // is vertex order[v] of the input
+    profile::Scope load_phase("relabel");
+    int degeneracy;
+    std::vector<int> order = degeneracy_order(input, degeneracy);
+    Graph graph = relabel(input, order);
+    load_phase.stop();
+    if (graph.n == 0) return result;
+
+    // Orient the graph once; both clique sizes are listed from it
+    profile::Scope listing_phase("clique_listing");
+    CliqueLister lister(graph);
+
+    // Count h-cliques and their per-vertex degrees without storing them
+    if (out) *out << "Finding " << h << "-cliques..." << std::endl;
+    std::vector<ll> clique_degrees;
+    ll num_h_cliques = dsd::clique_degrees(lister, h, clique_degrees, threads);
+    if (out) *out << "Found " << num_h_cliques << " " << h << "-cliques" << std::endl;
+    if (num_h_cliques == 0) return result;
+
+    // Find (h-1)-cliques
+    if (out) *out << "Finding " << (h - 1) << "-cliques..." << std::endl;
+    CliqueStore h_minus_1_cliques = collect_cliques(lister, h - 1, nullptr, threads, opt.spill);
+    if (out) *out << "Found " << h_minus_1_cliques.size() << " " << (h - 1) << "-cliques" << std::endl;
+    listing_phase.stop();
+
+    result = exact_search(graph, clique_degrees, num_h_cliques, h_minus_1_cliques, opt);
+    for (int& v : result.vertices) v = order[v];
+    std::sort(result.vertices.begin(), result.vertices.end());
+    return result;
+}
+
+// ------------------------ Batch over h ------------------------
+//
+// The exact search for every h in [lo, hi] on one relabeling and one clique
+// traversal: listing up to hi-cliques passes through every smaller clique as
+// a prefix, so the h-clique degrees and the (h-1)-clique stores of all the
+// searches fall out of a single recursion instead of hi - lo + 1 pairs of
+// listings. Results are indexed by h - lo. With `parallel_h` the searches
+// run concurrently, one thread each and without the log; otherwise they run
+// in turn with opt.threads.
+
+inline std::vector<SearchResult> exact_densest_range(const Graph& input, int lo, int hi, const SearchOptions& opt,
+                                                     bool parallel_h = false) {
+    lo = std::max(lo, 2);
+    std::vector<SearchResult> results(std::max(0, hi - lo + 1));
+    if (results.empty()) return results;
+
+    profile::Scope load_phase("relabel");
+    int degeneracy;
+    std::vector<int> order = degeneracy_order(input, degeneracy);
+    Graph graph = relabel(input, order);
+    load_phase.stop();
+    if (graph.n == 0) return results;
+
+    // Only the (h-1)-cliques of the searches are stored; every size is counted
+    profile::Scope listing_phase("clique_listing");
+    std::vector<char> keep(hi + 1, 0);
+    for (int h = lo; h <= hi; h++) keep[h - 1] = 1;
+    if (opt.log) *opt.log << "Listing cliques of up to " << hi << " vertices..." << std::endl;
+    CliqueLevels levels = clique_levels(CliqueLister(graph), hi, keep, opt.threads, opt.spill, lo);
+    listing_phase.stop();
+
+    // (h-1) = 1: the single vertices, which the traversal doesn't store
+    CliqueStore singles(1);
+    if (lo == 2) {
+        for (int v = 0; v < graph.n; v++) singles.push(&v);
+    }
+
+    auto search = [&](int h, const SearchOptions& o) {
+        SearchOptions local = o;
+        local.h = h;
+        const CliqueStore& store = h == 2 ? singles : levels.store[h - 1];
+        if (local.log) *local.log << "Searching h = " << h << " (" << levels.count[h] << " " << h << "-cliques, " << store.size() << " " << (h - 1) << "-cliques)" << std::endl;
+        SearchResult r = exact_search(graph, levels.degree[h], levels.count[h], store, local);
+        for (int& v : r.vertices) v = order[v];
+        std::sort(r.vertices.begin(), r.vertices.end());
+        results[h - lo] = std::move(r);
+    };
+
+    if (parallel_h) {
+        SearchOptions single = opt;
+        single.threads = 1;
+        single.log = nullptr;
+        parallel_for(hi - lo + 1, opt.threads, 1, [&](long long begin, long long end, int) {
+            for (long long i = begin; i < end; i++) search(lo + i, single);
+        });
+    } else {
+        for (int h = lo; h <= hi; h++) search(h, opt);
+    }
+    return results;
+}
+
+} // namespace dsd
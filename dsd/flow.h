@@ -0,0 +1,548 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "profile.h"
+
+namespace dsd {
+
+typedef long long ll;
+const ll INF = 1e18;
+
+// ------------------------ Flow Network ------------------------
+//
+// The residual graph is frozen after construction and stored in CSR form with
+// structure-of-arrays fields: the arcs leaving u are [first[u], first[u+1]),
+// arc a points to head[a], has residual capacity residual[a], and its twin is
+// rev[a]. Twins start at capacity 0, so the flow on a is residual[rev[a]] and
+// no capacity or flow array is kept. Capacities are int32 whenever the
+// network's finite capacities allow it.
+//
+// Networks are built by running the same builder callback twice: the first
+// pass (ArcCounter) only counts arcs per node, the second fills them in place.
+
+template <class Cap>
+struct FlowGraph {
+    // Stands in for INF; leaves headroom so residual + flow never overflows
+    static constexpr Cap INF_CAP = std::numeric_limits<Cap>::max() / 4;
+
+    int n = 0;
+    std::vector<long long> first;
+    std::vector<int> head;
+    std::vector<long long> rev;
+    std::vector<Cap> residual;
+
+    // Parametric helper node x, with one arc x -> v per sink-arc tail v
+    int helper = -1;
+    std::vector<long long> helper_arc;
+
+    std::vector<long long> fill; // next free slot per node while building
+
+    long long num_arcs() const { return head.size(); }
+    ll flow(long long a) const { return residual[rev[a]]; }
+
+    // Returns the id of the forward arc.
+    long long add_edge(int u, int v, ll cap) {
+        long long a = fill[u]++, b = fill[v]++;
+        head[a] = v; rev[a] = b; residual[a] = cap >= INF_CAP ? INF_CAP : (Cap)cap;
+        head[b] = u; rev[b] = a; residual[b] = 0;
+        return a;
+    }
+
+    // An arc v -> t whose capacity is later moved by set_sink_capacity.
+    long long add_sink_edge(int v, int t, ll cap) {
+        long long a = add_edge(v, t, cap);
+        if (helper_arc[v] < 0) helper_arc[v] = add_edge(helper, v, 0);
+        return a;
+    }
+};
+
+// First build pass: arcs per node, and the sum of finite capacities, which
+// decides the capacity width.
+struct ArcCounter {
+    int n;
+    std::vector<long long> degree; // one extra slot for the helper node
+    std::vector<char> has_helper_arc;
+    ll finite = 0;
+    bool parametric = false;
+
+    ArcCounter(int n) : n(n), degree(n + 1, 0), has_helper_arc(n, 0) {}
+
+    long long add_edge(int u, int v, ll cap) {
+        degree[u]++;
+        degree[v]++;
+        if (cap < INF) finite += cap;
+        return -1;
+    }
+
+    long long add_sink_edge(int v, int t, ll cap) {
+        add_edge(v, t, cap);
+        parametric = true;
+        if (!has_helper_arc[v]) {
+            has_helper_arc[v] = 1;
+            degree[n]++;
+            degree[v]++;
+        }
+        return -1;
+    }
+};
+
+// ------------------------ Max-Flow Interface ------------------------
+//
+// Engines only differ in how max_flow augments the shared residual graph, so
+// min_cut and parametric updates are written once in FlowSolver.
+
+struct MaxFlow {
+    virtual ~MaxFlow() {}
+
+    // Augments the current flow to a maximum one and returns the amount
+    // added. `blocked` (if any) is never entered.
+    virtual ll max_flow(int s, int t, int blocked = -1) = 0;
+
+    // Value of the current flow.
+    virtual ll outflow(int s) const = 0;
+
+    // Source side of the minimum cut: nodes reachable from s in the residual graph.
+    virtual std::vector<int> min_cut(int s) const = 0;
+
+    // Largest source side of a minimum cut: nodes that can't reach t in the
+    // residual graph.
+    virtual std::vector<int> max_cut(int t) const = 0;
+
+    // Moves every arc in `sink_arcs` (from add_sink_edge) to capacity `cap`,
+    // keeping as much of the current flow as stays feasible.
+    virtual void set_sink_capacity(const std::vector<long long>& sink_arcs, ll cap, int s, int t) = 0;
+
+    virtual long long num_arcs() const = 0;
+    virtual size_t memory_bytes() const = 0;
+};
+
+// ------------------------ Dinic ------------------------
+
+template <class Cap>
+struct Dinic {
+    std::vector<int> level;
+    std::vector<long long> ptr, path;
+    long long paths = 0; // augmenting paths, reported once per max_flow
+
+    bool bfs(const FlowGraph<Cap>& g, int s, int t, int blocked) {
+        level.assign(g.n, -1);
+        if (blocked >= 0) level[blocked] = -2;
+        std::queue<int> q;
+        level[s] = 0;
+        q.push(s);
+
+        while (!q.empty()) {
+            int u = q.front(); q.pop();
+            for (long long a = g.first[u]; a < g.first[u + 1]; a++) {
+                int v = g.head[a];
+                if (g.residual[a] > 0 && level[v] == -1) {
+                    level[v] = level[u] + 1;
+                    q.push(v);
+                }
+            }
+        }
+        return level[t] >= 0;
+    }
+
+    // Blocking flow on the current level graph by an iterative DFS. The
+    // augmenting path is kept as a stack of arc ids. On reaching t the
+    // bottleneck is pushed and the stack is cut back only to the tail of the
+    // first saturated arc, so the next path reuses the surviving prefix
+    // instead of restarting from s. Dead ends pop one arc and advance the
+    // parent's pointer, exactly as the recursive version did, but on the heap.
+    ll blocking_flow(FlowGraph<Cap>& g, int s, int t) {
+        ll total = 0;
+        path.clear();
+        int u = s;
+
+        while (true) {
+            if (u == t) {
+                ll pushed = INF;
+                for (long long a : path) pushed = std::min<ll>(pushed, g.residual[a]);
+                for (long long a : path) {
+                    g.residual[a] -= pushed;
+                    g.residual[g.rev[a]] += pushed;
+                }
+                total += pushed;
+                paths++;
+
+                size_t keep = 0;
+                while (keep < path.size() && g.residual[path[keep]] > 0) keep++;
+                path.resize(keep);
+                u = keep ? g.head[path[keep - 1]] : s;
+                continue;
+            }
+
+            bool advanced = false;
+            for (long long& a = ptr[u]; a < g.first[u + 1]; ++a) {
+                int v = g.head[a];
+                if (g.residual[a] > 0 && level[v] == level[u] + 1) {
+                    path.push_back(a);
+                    u = v;
+                    advanced = true;
+                    break;
+                }
+            }
+            if (advanced) continue;
+
+            // Dead end: u is exhausted for this phase
+            if (path.empty()) break;
+            u = g.head[g.rev[path.back()]];
+            path.pop_back();
+            ptr[u]++;
+        }
+        return total;
+    }
+
+    ll max_flow(FlowGraph<Cap>& g, int s, int t, int blocked) {
+        ll flow = 0;
+        long long phases = 0;
+        paths = 0;
+        while (bfs(g, s, t, blocked)) {
+            ptr.assign(g.first.begin(), g.first.end() - 1);
+            flow += blocking_flow(g, s, t);
+            phases++;
+        }
+        profile::count(profile::MAX_FLOWS);
+        profile::count(profile::BFS_PHASES, phases);
+        profile::count(profile::AUGMENTING_PATHS, paths);
+        return flow;
+    }
+};
+
+// ------------------------ Highest-Label Push-Relabel ------------------------
+//
+// Phase 1 saturates the source arcs and discharges the highest active node
+// first, with periodic global relabeling (exact distances by reverse BFS)
+// and the gap heuristic (a height nobody occupies cuts everything above it
+// off from the sink). That yields a maximum preflow. Phase 2 runs the same
+// discharge loop towards s to return the stranded excess, so the result is a
+// genuine flow and min_cut sees the same residual graph Dinic would leave.
+
+template <class Cap>
+struct PushRelabel {
+    int n = 0;
+    std::vector<ll> excess;
+    std::vector<int> height;
+    std::vector<long long> cur;
+    std::vector<std::vector<int>> active, layer; // by height: nodes with excess / all nodes
+    std::vector<int> layer_pos;
+    int max_layer = 0;
+    long long pushes = 0, relabels = 0, global_relabels = 0; // reported once per max_flow
+
+    ll max_flow(FlowGraph<Cap>& g, int s, int t, int blocked) {
+        n = g.n;
+        pushes = relabels = global_relabels = 0;
+        excess.assign(n, 0);
+        for (long long a = g.first[s]; a < g.first[s + 1]; a++) {
+            if (g.residual[a] > 0 && g.head[a] != blocked) push(g, s, a, g.residual[a]);
+        }
+        discharge_all(g, t, s, blocked);   // max preflow
+        ll flow = excess[t];
+        discharge_all(g, s, t, blocked);   // return stranded excess
+        profile::count(profile::MAX_FLOWS);
+        profile::count(profile::PUSHES, pushes);
+        profile::count(profile::RELABELS, relabels);
+        profile::count(profile::GLOBAL_RELABELS, global_relabels);
+        return flow;
+    }
+
+private:
+    void push(FlowGraph<Cap>& g, int u, long long a, ll amount) {
+        pushes++;
+        g.residual[a] -= amount;
+        g.residual[g.rev[a]] += amount;
+        excess[u] -= amount;
+        excess[g.head[a]] += amount;
+    }
+
+    void layer_add(int v) {
+        max_layer = std::max(max_layer, height[v]);
+        layer_pos[v] = layer[height[v]].size();
+        layer[height[v]].push_back(v);
+    }
+
+    void layer_remove(int v) {
+        std::vector<int>& l = layer[height[v]];
+        int last = l.back();
+        l[layer_pos[v]] = last;
+        layer_pos[last] = layer_pos[v];
+        l.pop_back();
+    }
+
+    // Exact heights: BFS distance to `target` over residual arcs. Nodes that
+    // can't reach it get height n and drop out of the discharge loop.
+    void global_relabel(const FlowGraph<Cap>& g, int target, int other, int blocked, int& top) {
+        global_relabels++;
+        height.assign(n, n);
+        if (blocked >= 0) height[blocked] = 2 * n;
+        for (auto& l : layer) l.clear();
+        for (auto& a : active) a.clear();
+        max_layer = 0;
+
+        std::queue<int> q;
+        height[target] = 0;
+        q.push(target);
+        while (!q.empty()) {
+            int v = q.front(); q.pop();
+            for (long long a = g.first[v]; a < g.first[v + 1]; a++) {
+                // residual arc u -> v is the twin of v -> u
+                int u = g.head[a];
+                if (g.residual[g.rev[a]] > 0 && height[u] == n && u != other) {
+                    height[u] = height[v] + 1;
+                    q.push(u);
+                }
+            }
+        }
+
+        top = 0;
+        for (int v = 0; v < n; v++) {
+            if (height[v] >= n) continue;
+            layer_add(v);
+            if (excess[v] > 0 && v != target) {
+                active[height[v]].push_back(v);
+                top = std::max(top, height[v]);
+            }
+        }
+    }
+
+    void discharge_all(FlowGraph<Cap>& g, int target, int other, int blocked) {
+        active.assign(n + 1, {});
+        layer.assign(n + 1, {});
+        layer_pos.assign(n, 0);
+        cur.assign(g.first.begin(), g.first.end() - 1);
+
+        int top;
+        global_relabel(g, target, other, blocked, top);
+        long long work = 0, relabel_period = 6LL * n + g.num_arcs();
+
+        while (top >= 0) {
+            if (active[top].empty()) { top--; continue; }
+            int u = active[top].back();
+            active[top].pop_back();
+            if (height[u] != top || excess[u] <= 0) continue; // stale
+
+            // Discharge u
+            while (excess[u] > 0) {
+                if (cur[u] == g.first[u + 1]) {
+                    // Relabel to one above the lowest residual neighbor
+                    int old = height[u], best = 2 * n;
+                    for (long long a = g.first[u]; a < g.first[u + 1]; a++) {
+                        if (g.residual[a] > 0) best = std::min(best, height[g.head[a]] + 1);
+                    }
+                    work += g.first[u + 1] - g.first[u] + 12;
+                    relabels++;
+                    cur[u] = g.first[u];
+                    layer_remove(u);
+
+                    if (layer[old].empty()) {
+                        // Gap: nothing above `old` can reach the target any more
+                        for (int h = old + 1; h <= max_layer; h++) {
+                            for (int v : layer[h]) height[v] = n;
+                            layer[h].clear();
+                        }
+                        max_layer = old - 1;
+                        best = n;
+                    }
+                    height[u] = std::min(best, n);
+                    if (height[u] >= n) break;
+                    layer_add(u);
+                    continue;
+                }
+
+                long long a = cur[u];
+                int v = g.head[a];
+                if (g.residual[a] > 0 && height[u] == height[v] + 1) {
+                    bool was_idle = excess[v] == 0;
+                    push(g, u, a, std::min<ll>(excess[u], g.residual[a]));
+                    if (was_idle && v != target && v != other) {
+                        active[height[v]].push_back(v);
+                        top = std::max(top, height[v]); // u may have been relabeled above top
+                    }
+                } else {
+                    cur[u]++;
+                }
+            }
+
+            if (excess[u] > 0 && height[u] < n) {
+                active[height[u]].push_back(u);
+                top = std::max(top, height[u]);
+            }
+
+            if (work > relabel_period) {
+                work = 0;
+                global_relabel(g, target, other, blocked, top);
+                cur.assign(g.first.begin(), g.first.end() - 1);
+            }
+        }
+    }
+};
+
+// ------------------------ Solver ------------------------
+
+template <class Cap, template <class> class Engine>
+struct FlowSolver : MaxFlow {
+    FlowGraph<Cap> g;
+    Engine<Cap> engine;
+
+    ll max_flow(int s, int t, int blocked = -1) override {
+        return engine.max_flow(g, s, t, blocked);
+    }
+
+    ll outflow(int s) const override {
+        ll flow = 0;
+        for (long long a = g.first[s]; a < g.first[s + 1]; a++) flow += g.flow(a);
+        return flow;
+    }
+
+    std::vector<int> min_cut(int s) const override {
+        std::vector<bool> visited(g.n, false);
+        std::queue<int> q;
+        q.push(s);
+        visited[s] = true;
+
+        while (!q.empty()) {
+            int u = q.front(); q.pop();
+            for (long long a = g.first[u]; a < g.first[u + 1]; a++) {
+                int v = g.head[a];
+                if (g.residual[a] > 0 && !visited[v]) {
+                    visited[v] = true;
+                    q.push(v);
+                }
+            }
+        }
+
+        std::vector<int> cut;
+        for (int i = 0; i < g.n; i++) {
+            if (visited[i] && i != g.helper) cut.push_back(i);
+        }
+        return cut;
+    }
+
+    // Walks the residual graph backwards from t: an arc u -> v with residual
+    // capacity lets u reach t if v does.
+    std::vector<int> max_cut(int t) const override {
+        std::vector<bool> visited(g.n, false);
+        std::queue<int> q;
+        q.push(t);
+        visited[t] = true;
+
+        while (!q.empty()) {
+            int v = q.front(); q.pop();
+            for (long long a = g.first[v]; a < g.first[v + 1]; a++) {
+                int u = g.head[a];
+                if (g.residual[g.rev[a]] > 0 && !visited[u]) {
+                    visited[u] = true;
+                    q.push(u);
+                }
+            }
+        }
+
+        std::vector<int> cut;
+        for (int i = 0; i < g.n; i++) {
+            if (!visited[i] && i != g.helper) cut.push_back(i);
+        }
+        return cut;
+    }
+
+    // ---- Parametric sink capacities ----
+    //
+    // Between binary-search iterations only the v -> t capacities move, so the
+    // network and its flow are kept. Raising a capacity keeps the flow
+    // feasible and max_flow simply augments on top of it. Lowering one below
+    // its current flow leaves excess at v, which is routed back to s first
+    // (in the spirit of Gallo-Grigoriadis-Tarjan): the helper node x feeds
+    // every over-full v its excess and a max-flow from x to s, with t blocked,
+    // cancels exactly that much flow along residual paths. Flow
+    // decomposition guarantees those paths exist.
+    void set_sink_capacity(const std::vector<long long>& sink_arcs, ll cap, int s, int t) override {
+        cap = std::min<ll>(cap, FlowGraph<Cap>::INF_CAP);
+        std::vector<long long> over;
+        for (long long a : sink_arcs) {
+            if (g.flow(a) > cap) over.push_back(a);
+        }
+
+        if (!over.empty()) {
+            for (long long a : over) {
+                int v = g.head[g.rev[a]];
+                g.residual[g.helper_arc[v]] = g.flow(a) - cap;
+            }
+
+            engine.max_flow(g, g.helper, s, t);
+
+            // x's arcs are saturated; retire them and take the flow off v -> t
+            for (long long a : over) {
+                long long x = g.helper_arc[g.head[g.rev[a]]];
+                g.residual[g.rev[a]] -= g.flow(x);
+                g.residual[x] = g.residual[g.rev[x]] = 0;
+            }
+        }
+
+        for (long long a : sink_arcs) g.residual[a] = cap - g.flow(a);
+    }
+
+    long long num_arcs() const override { return g.num_arcs(); }
+
+    size_t memory_bytes() const override {
+        return g.first.size() * sizeof(long long) + g.head.size() * sizeof(int) +
+               g.rev.size() * sizeof(long long) + g.residual.size() * sizeof(Cap);
+    }
+};
+
+inline bool valid_flow_engine(const std::string& engine) {
+    return engine == "dinic" || engine == "push-relabel" || engine == "pr";
+}
+
+// Second build pass: lays out the CSR arrays from the counts and fills them.
+template <class Cap, template <class> class Engine, class Build>
+std::unique_ptr<MaxFlow> fill_flow_solver(const ArcCounter& counter, Build& build) {
+    auto solver = std::make_unique<FlowSolver<Cap, Engine>>();
+    FlowGraph<Cap>& g = solver->g;
+    g.n = counter.n + (counter.parametric ? 1 : 0);
+    g.first.assign(g.n + 1, 0);
+    for (int u = 0; u < g.n; u++) g.first[u + 1] = g.first[u] + counter.degree[u];
+    g.head.resize(g.first[g.n]);
+    g.rev.resize(g.first[g.n]);
+    g.residual.resize(g.first[g.n]);
+    g.fill.assign(g.first.begin(), g.first.end() - 1);
+    if (counter.parametric) {
+        g.helper = counter.n;
+        g.helper_arc.assign(counter.n, -1);
+    }
+
+    build(g);
+    g.fill = std::vector<long long>();
+    profile::count(profile::ARCS, g.num_arcs());
+    profile::count(profile::NETWORK_BYTES, solver->memory_bytes());
+    return solver;
+}
+
+// Builds a frozen network on nodes [0, n) with the named engine ("dinic" or
+// "push-relabel" / "pr"); returns null if the name is unknown. build(net) is
+// called twice and must add the same arcs both times through
+// net.add_edge(u, v, cap) and net.add_sink_edge(v, t, cap). Both return the
+// arc id on the filling pass (and -1 on the counting pass). `cap_bound` is
+// the largest capacity later passed to set_sink_capacity.
+template <class Build>
+std::unique_ptr<MaxFlow> build_max_flow(const std::string& engine, int n, ll cap_bound, Build&& build) {
+    if (!valid_flow_engine(engine)) return nullptr;
+    ArcCounter counter(n);
+    build(counter);
+
+    bool narrow = std::max(counter.finite, cap_bound) < FlowGraph<int32_t>::INF_CAP;
+    if (engine == "dinic") {
+        if (narrow) return fill_flow_solver<int32_t, Dinic>(counter, build);
+        return fill_flow_solver<int64_t, Dinic>(counter, build);
+    }
+    if (narrow) return fill_flow_solver<int32_t, PushRelabel>(counter, build);
+    return fill_flow_solver<int64_t, PushRelabel>(counter, build);
+}
+
+} // namespace dsd
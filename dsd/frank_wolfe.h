@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "graph.h"
+#include "kclist.h"
+#include "parallel.h"
+
+namespace dsd {
+
+// ------------------------ Frank-Wolfe Load Balancing ------------------------
+//
+// The densest-subgraph LP dual: every h-clique splits one unit of weight
+// among its members, and the largest resulting vertex load b_v bounds ρ*
+// from above (the cliques of the densest subgraph D all land on D, so some
+// vertex of D carries at least ρ*). Frank-Wolfe minimizes the sum of squared
+// loads: each step sends every clique's unit to its least loaded member and
+// mixes that in with step 2/(t+2). The loads converge to the density
+// decomposition, so sorting vertices by load and taking the densest prefix
+// rounds them to a subgraph whose density converges to ρ*.
+//
+// A step is one parallel sweep over the flat clique list; each thread counts
+// into its own array and the arrays are summed, so the result doesn't depend
+// on the thread count.
+
+struct FrankWolfeResult {
+    std::vector<int> vertices; // densest prefix, ids of the graph
+    long long cliques = 0;     // h-cliques inside it
+    double density = 0;        // lower bound on ρ*
+    double upper = 0;          // certified upper bound on ρ*
+    int iterations = 0;
+};
+
+// Densest prefix of the vertices sorted by decreasing load.
+inline void round_loads(const CliqueStore& store, int n, const std::vector<double>& load, int threads,
+                        FrankWolfeResult& result) {
+    std::vector<int> order(n), rank(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return load[a] != load[b] ? load[a] > load[b] : a < b;
+    });
+    for (int i = 0; i < n; i++) rank[order[i]] = i;
+
+    // A clique is inside a prefix once its last-ranked member is
+    long long m = store.size();
+    int k = store.k;
+    std::vector<std::vector<long long>> local(threads);
+    parallel_for(m, threads, 1 << 14, [&](long long begin, long long end, int tid) {
+        if (local[tid].empty()) local[tid].assign(n, 0);
+        for (long long c = begin; c < end; c++) {
+            const int* clique = store[c];
+            int last = 0;
+            for (int i = 0; i < k; i++) last = std::max(last, rank[clique[i]]);
+            local[tid][last]++;
+        }
+    });
+
+    long long cliques = 0;
+    int best = -1;
+    for (int i = 0; i < n; i++) {
+        for (const auto& l : local) {
+            if (!l.empty()) cliques += l[i];
+        }
+        double density = (double)cliques / (i + 1);
+        if (density > result.density) {
+            result.density = density;
+            result.cliques = cliques;
+            best = i;
+        }
+    }
+    if (best >= 0) result.vertices.assign(order.begin(), order.begin() + best + 1);
+}
+
+// Runs up to `iterations` Frank-Wolfe steps, checking the bounds every 10
+// and stopping once they are within a relative `gap`.
+inline FrankWolfeResult frank_wolfe_densest(const Graph& g, int h, int iterations = 100, double gap = 1e-3, int threads = 1,
+                                            const SpillPolicy& spill = SpillPolicy()) {
+    threads = resolve_threads(threads);
+    int n = g.n;
+    FrankWolfeResult result;
+    CliqueStore store = collect_cliques(CliqueLister(g), h, nullptr, threads, spill);
+    long long m = store.size();
+    if (m == 0) return result;
+
+    // Start from the even split: every member gets 1/h of each clique
+    std::vector<double> load(n, 0);
+    for (long long c = 0; c < m; c++) {
+        for (int i = 0; i < h; i++) load[store[c][i]] += 1.0 / h;
+    }
+
+    // Every load vector is a feasible split, so each gives an upper bound
+    result.upper = *std::max_element(load.begin(), load.end());
+    round_loads(store, n, load, threads, result);
+
+    std::vector<std::vector<double>> local(threads);
+    for (int t = 0; t < iterations && result.upper - result.density > gap * result.upper; t++) {
+        result.iterations++;
+
+        // Linear minimization: each clique's unit goes to its least loaded member
+        parallel_for(m, threads, 1 << 14, [&](long long begin, long long end, int tid) {
+            if (local[tid].empty()) local[tid].assign(n, 0);
+            for (long long c = begin; c < end; c++) {
+                const int* clique = store[c];
+                int best = clique[0];
+                for (int i = 1; i < h; i++) {
+                    int v = clique[i];
+                    if (load[v] < load[best] || (load[v] == load[best] && v < best)) best = v;
+                }
+                local[tid][best] += 1;
+            }
+        });
+
+        double step = 2.0 / (t + 2);
+        parallel_for(n, threads, 1 << 14, [&](long long begin, long long end, int) {
+            for (long long v = begin; v < end; v++) {
+                double target = 0;
+                for (auto& l : local) {
+                    if (l.empty()) continue;
+                    target += l[v];
+                    l[v] = 0;
+                }
+                load[v] = (1 - step) * load[v] + step * target;
+            }
+        });
+
+        if (t + 1 == iterations || t % 10 == 9) {
+            result.upper = std::min(result.upper, *std::max_element(load.begin(), load.end()));
+            round_loads(store, n, load, threads, result);
+        }
+    }
+    std::sort(result.vertices.begin(), result.vertices.end());
+    return result;
+}
+
+} // namespace dsd
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace dsd {
+
+// ------------------------ Synthetic Graph Generators ------------------------
+//
+// Seeded generators for benchmark inputs. Every generator draws from its own
+// std::mt19937_64, whose output the standard fixes. The std distributions and
+// std::shuffle are left to the library, so the draws are mapped to ranges by
+// hand below; the same parameters and seed then give the same edge list on
+// every platform. The output is a simple undirected edge list on [0, n) with
+// u < v, no self-loops and no duplicates.
+
+typedef std::vector<std::pair<int, int>> EdgeList;
+
+// A uniform double in [0, 1) from the top 53 bits of one draw.
+inline double uniform_real(std::mt19937_64& rng) {
+    return (rng() >> 11) * 0x1.0p-53;
+}
+
+// A uniform integer in [0, n), rejecting the draws past the last full
+// multiple of n so no value is favored.
+inline uint64_t uniform_int(std::mt19937_64& rng, uint64_t n) {
+    uint64_t limit = UINT64_MAX - UINT64_MAX % n;
+    uint64_t x;
+    do {
+        x = rng();
+    } while (x >= limit);
+    return x % n;
+}
+
+// Fisher-Yates, drawing with uniform_int.
+template <class T>
+void shuffle(std::vector<T>& items, std::mt19937_64& rng) {
+    for (size_t i = items.size(); i > 1; i--) std::swap(items[i - 1], items[uniform_int(rng, i)]);
+}
+
+// Collects distinct undirected edges.
+struct EdgeSet {
+    EdgeList edges;
+
+    bool add(int u, int v) {
+        if (u == v) return false;
+        if (u > v) std::swap(u, v);
+        if (!seen.insert((uint64_t)u << 32 | (uint32_t)v).second) return false;
+        edges.push_back({u, v});
+        return true;
+    }
+
+private:
+    std::unordered_set<uint64_t> seen;
+};
+
+// G(n, m): m distinct edges chosen uniformly.
+inline EdgeList erdos_renyi(int n, long long m, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    auto pick = [&] { return (int)uniform_int(rng, n); };
+    m = std::min(m, (long long)n * (n - 1) / 2);
+    EdgeSet set;
+    while ((long long)set.edges.size() < m) {
+        int u = pick();
+        set.add(u, pick());
+    }
+    return set.edges;
+}
+
+// R-MAT: each edge descends log2(n) levels of the adjacency matrix, picking
+// a quadrant with probabilities a, b, c and 1-a-b-c. Skewed parameters give
+// the heavy-tailed degrees of web and collaboration graphs. Ids past n are
+// redrawn, and the loop gives up after 20m draws so tiny graphs terminate.
+inline EdgeList rmat(int n, long long m, double a, double b, double c, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    int levels = 0;
+    while ((1LL << levels) < n) levels++;
+    EdgeSet set;
+    for (long long draws = 0; (long long)set.edges.size() < m && draws < 20 * m; draws++) {
+        int u = 0, v = 0;
+        for (int i = 0; i < levels; i++) {
+            double r = uniform_real(rng);
+            int bit_u = r >= a + b;
+            int bit_v = (r >= a && r < a + b) || r >= a + b + c;
+            u = u << 1 | bit_u;
+            v = v << 1 | bit_v;
+        }
+        if (u < n && v < n) set.add(u, v);
+    }
+    return set.edges;
+}
+
+// G(n, m) background with a planted set of k random vertices whose pairs are
+// joined with probability p: a known dense region for checking answers.
+inline EdgeList planted(int n, long long m, int k, double p, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<int> ids(n);
+    for (int v = 0; v < n; v++) ids[v] = v;
+    shuffle(ids, rng);
+
+    EdgeSet set;
+    for (int i = 0; i < k; i++) {
+        for (int j = i + 1; j < k; j++) {
+            if (uniform_real(rng) < p) set.add(ids[i], ids[j]);
+        }
+    }
+    long long target = std::min((long long)set.edges.size() + m, (long long)n * (n - 1) / 2);
+    while ((long long)set.edges.size() < target) {
+        int u = uniform_int(rng, n);
+        set.add(u, uniform_int(rng, n));
+    }
+    return set.edges;
+}
+
+// Writes "u v" lines, the format read_graph expects.
+inline bool write_edge_list(const std::string& filename, const EdgeList& edges) {
+    std::ofstream out(filename);
+    if (!out) return false;
+    for (const auto& [u, v] : edges) out << u << ' ' << v << '\n';
+    return (bool)out;
+}
+
+} // namespace dsd
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace dsd {
+
+// ------------------------ CSR Graph ------------------------
+//
+// Undirected simple graph in compressed sparse row form: the neighbors of v
+// are nbrs[offsets[v] .. offsets[v+1]), sorted ascending with no duplicates
+// or self-loops. `label` maps each vertex back to its id in the input file,
+// so relabeled graphs and induced subgraphs can still report original ids.
+
+struct Neighbors {
+    const int* first;
+    const int* last;
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    int size() const { return last - first; }
+};
+
+struct Graph {
+    int n = 0;
+    std::vector<long long> offsets{0};
+    std::vector<int> nbrs;
+    std::vector<int> label;
+
+    long long num_edges() const { return nbrs.size() / 2; }
+    int degree(int v) const { return offsets[v + 1] - offsets[v]; }
+    Neighbors neighbors(int v) const { return {nbrs.data() + offsets[v], nbrs.data() + offsets[v + 1]}; }
+
+    bool has_edge(int u, int v) const {
+        Neighbors nu = neighbors(u);
+        return std::binary_search(nu.begin(), nu.end(), v);
+    }
+
+    int max_degree() const {
+        int d = 0;
+        for (int v = 0; v < n; v++) d = std::max(d, degree(v));
+        return d;
+    }
+};
+
+// Builds a graph on vertices [0, n) from an arbitrary edge list. Both
+// directions are added, then each row is sorted and deduplicated in place.
+inline Graph build_graph(int n, const std::vector<std::pair<int, int>>& edges) {
+    Graph g;
+    g.n = n;
+    g.label.resize(n);
+    for (int v = 0; v < n; v++) g.label[v] = v;
+
+    std::vector<long long> fill(n + 1, 0);
+    for (const auto& [u, v] : edges) {
+        if (u == v) continue; // Skip self-loops
+        fill[u + 1]++;
+        fill[v + 1]++;
+    }
+    for (int v = 0; v < n; v++) fill[v + 1] += fill[v];
+
+    std::vector<int> raw(fill[n]);
+    std::vector<long long> pos(fill.begin(), fill.end() - 1);
+    for (const auto& [u, v] : edges) {
+        if (u == v) continue;
+        raw[pos[u]++] = v;
+        raw[pos[v]++] = u;
+    }
+
+    // Sort each row and compact the deduplicated rows to the front
+    g.offsets.assign(n + 1, 0);
+    long long out = 0;
+    for (int v = 0; v < n; v++) {
+        auto first = raw.begin() + fill[v], last = raw.begin() + fill[v + 1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+        for (auto it = first; it != last; ++it) raw[out++] = *it;
+        g.offsets[v + 1] = out;
+    }
+    raw.resize(out);
+    raw.shrink_to_fit();
+    g.nbrs = std::move(raw);
+    return g;
+}
+
+// Subgraph induced by `vertices`; vertex i of the result is vertices[i].
+inline Graph induced_subgraph(const Graph& g, const std::vector<int>& vertices) {
+    std::vector<int> mapping(g.n, -1);
+    for (int i = 0; i < (int)vertices.size(); i++) mapping[vertices[i]] = i;
+
+    Graph sub;
+    sub.n = vertices.size();
+    sub.label.resize(sub.n);
+    sub.offsets.assign(sub.n + 1, 0);
+    for (int i = 0; i < sub.n; i++) {
+        int v = vertices[i];
+        sub.label[i] = g.label[v];
+        for (int u : g.neighbors(v)) {
+            if (mapping[u] != -1) sub.nbrs.push_back(mapping[u]);
+        }
+        // Mapping is not monotone in general, so re-sort the row
+        std::sort(sub.nbrs.begin() + sub.offsets[i], sub.nbrs.end());
+        sub.offsets[i + 1] = sub.nbrs.size();
+    }
+    return sub;
+}
+
+// Renumbers vertices so that new vertex i is old vertex order[i].
+inline Graph relabel(const Graph& g, const std::vector<int>& order) {
+    return induced_subgraph(g, order);
+}
+
+// Matula-Beck bucket peeling. Returns the peel order (vertices in
+// non-decreasing core number) and sets `degeneracy` to the maximum core number.
+// If `core` is given it receives every vertex's core number.
+inline std::vector<int> degeneracy_order(const Graph& g, int& degeneracy, std::vector<int>* core = nullptr) {
+    int n = g.n;
+    int max_deg = g.max_degree();
+    std::vector<int> deg(n);
+    for (int v = 0; v < n; v++) deg[v] = g.degree(v);
+
+    // bin[d] = first position of degree-d vertices in `vert`
+    std::vector<int> bin(max_deg + 2, 0), pos(n), vert(n);
+    for (int v = 0; v < n; v++) bin[deg[v] + 1]++;
+    for (int d = 1; d <= max_deg + 1; d++) bin[d] += bin[d - 1];
+    for (int v = 0; v < n; v++) {
+        pos[v] = bin[deg[v]]++;
+        vert[pos[v]] = v;
+    }
+    for (int d = max_deg; d > 0; d--) bin[d] = bin[d - 1];
+    bin[0] = 0;
+
+    degeneracy = 0;
+    if (core) core->assign(n, 0);
+    for (int i = 0; i < n; i++) {
+        int v = vert[i];
+        degeneracy = std::max(degeneracy, deg[v]);
+        if (core) (*core)[v] = deg[v];
+        for (int u : g.neighbors(v)) {
+            if (deg[u] > deg[v]) {
+                int du = deg[u], pu = pos[u];
+                int pw = bin[du], w = vert[pw];
+                if (u != w) {
+                    pos[u] = pw; vert[pu] = w;
+                    pos[w] = pu; vert[pw] = u;
+                }
+                bin[du]++;
+                deg[u]--;
+            }
+        }
+    }
+    return vert;
+}
+
+// Connected components by BFS: returns each vertex's component id in
+// [0, count), numbered in order of their smallest vertex.
+inline std::vector<int> connected_components(const Graph& g, int& count) {
+    std::vector<int> comp(g.n, -1);
+    std::vector<int> queue;
+    count = 0;
+    for (int root = 0; root < g.n; root++) {
+        if (comp[root] != -1) continue;
+        comp[root] = count;
+        queue.assign(1, root);
+        for (size_t i = 0; i < queue.size(); i++) {
+            for (int u : g.neighbors(queue[i])) {
+                if (comp[u] == -1) {
+                    comp[u] = count;
+                    queue.push_back(u);
+                }
+            }
+        }
+        count++;
+    }
+    return comp;
+}
+
+// Relabels `g` along its degeneracy order, so vertices of similar core number
+// (and the dense core itself) sit in one contiguous id range.
+inline Graph relabel_by_degeneracy(const Graph& g) {
+    int degeneracy;
+    return relabel(g, degeneracy_order(g, degeneracy));
+}
+
+} // namespace dsd
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define DSD_HAVE_AVX2_KERNEL 1
+#endif
+
+namespace dsd {
+
+// ------------------------ Sorted Set Intersection ------------------------
+//
+// Intersections of sorted, duplicate-free id lists. The AVX2 kernel compares
+// a block of 8 ids from each side against all 8 rotations of the other, so one
+// step handles 64 pairs; the block with the smaller maximum is then
+// advanced. It is compiled for AVX2 regardless of the build flags and only
+// picked when the CPU supports it, with the scalar merge as the fallback.
+
+// Writes a ∩ b to out (which may alias a) and returns its length.
+inline int intersect_scalar(const int* a, int na, const int* b, int nb, int* out) {
+    int i = 0, j = 0, m = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) i++;
+        else if (b[j] < a[i]) j++;
+        else { out[m++] = a[i]; i++; j++; }
+    }
+    return m;
+}
+
+#ifdef DSD_HAVE_AVX2_KERNEL
+__attribute__((target("avx2,bmi")))
+inline int intersect_avx2(const int* a, int na, const int* b, int nb, int* out) {
+    int i = 0, j = 0, m = 0;
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        __m256i hit = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(va, vb));
+        }
+
+        // Read both maxima before writing: out may alias a
+        int a_max = a[i + 7], b_max = b[j + 7];
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+        while (mask) {
+            out[m++] = a[i + __builtin_ctz(mask)];
+            mask &= mask - 1;
+        }
+        if (a_max <= b_max) i += 8;
+        if (b_max <= a_max) j += 8;
+    }
+    return m + intersect_scalar(a + i, na - i, b + j, nb - j, out + m);
+}
+#endif
+
+inline bool has_avx2() {
+#ifdef DSD_HAVE_AVX2_KERNEL
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+// a ∩ b into out (which may alias a); returns the length.
+inline int intersect(const int* a, int na, const int* b, int nb, int* out) {
+#ifdef DSD_HAVE_AVX2_KERNEL
+    if (has_avx2()) return intersect_avx2(a, na, b, nb, out);
+#endif
+    return intersect_scalar(a, na, b, nb, out);
+}
+
+} // namespace dsd
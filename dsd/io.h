@@ -0,0 +1,207 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+#include "parallel.h"
+
+namespace dsd {
+
+// ------------------------ Edge List Loading ------------------------
+//
+// The file is memory-mapped and cut into one chunk per thread on line
+// boundaries. Each thread parses its chunk with a hand-rolled integer parser
+// into a private pair buffer; lines starting with '#' or '%' (SNAP / Matrix
+// Market headers) and lines without two integers are skipped.
+
+// Read-only view of a whole file; mmap when possible, read() otherwise.
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+    bool ok = false;
+
+    MappedFile(const std::string& filename) {
+        fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) != 0) return;
+        size = st.st_size;
+        ok = true;
+        if (size == 0) return;
+
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            mapped = p;
+            data = (const char*)p;
+            madvise(p, size, MADV_SEQUENTIAL);
+            return;
+        }
+        buffer.resize(size);
+        size_t got = 0;
+        while (got < size) {
+            ssize_t r = read(fd, &buffer[got], size - got);
+            if (r <= 0) break;
+            got += r;
+        }
+        size = got;
+        data = buffer.data();
+    }
+
+    ~MappedFile() {
+        if (mapped) munmap(mapped, size);
+        if (fd >= 0) close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+private:
+    int fd = -1;
+    void* mapped = nullptr;
+    std::string buffer;
+};
+
+// Parses lines of the form "<int> <int> ..." from [p, end).
+inline void parse_pairs(const char* p, const char* end, std::vector<std::pair<int, int>>& out) {
+    auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    auto skip_line = [&]() {
+        while (p < end && *p != '\n') p++;
+    };
+    auto parse_int = [&](int& x) {
+        bool neg = false;
+        if (p < end && *p == '-') { neg = true; p++; }
+        if (p >= end || *p < '0' || *p > '9') return false;
+        long long v = 0;
+        while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+        x = neg ? -v : v;
+        return true;
+    };
+
+    while (p < end) {
+        while (p < end && (is_space(*p) || *p == '\n')) p++;
+        if (p >= end) break;
+        if (*p == '#' || *p == '%') { skip_line(); continue; }
+
+        int u, v;
+        if (parse_int(u)) {
+            while (p < end && is_space(*p)) p++;
+            if (parse_int(v)) out.emplace_back(u, v);
+        }
+        skip_line();
+    }
+}
+
+// Parses every "<int> <int>" line of `filename` in parallel. Pairs are
+// returned per chunk, in file order. Returns false if the file can't be read.
+inline bool read_pairs(const std::string& filename, std::vector<std::vector<std::pair<int, int>>>& chunks, int threads = 0) {
+    MappedFile file(filename);
+    if (!file.ok) return false;
+
+    // Don't bother splitting small files
+    const size_t min_chunk = 1 << 20;
+    int parts = resolve_threads(threads);
+    parts = std::max<size_t>(1, std::min<size_t>(parts, file.size / min_chunk + 1));
+
+    // Chunk i covers [bounds[i], bounds[i+1]); every bound starts a line
+    std::vector<size_t> bounds(parts + 1, file.size);
+    bounds[0] = 0;
+    for (int i = 1; i < parts; i++) {
+        size_t b = std::max(bounds[i - 1], file.size / parts * i);
+        while (b < file.size && file.data[b - 1] != '\n') b++;
+        bounds[i] = b;
+    }
+
+    chunks.assign(parts, {});
+    run_threads(parts, [&](int t) {
+        chunks[t].reserve((bounds[t + 1] - bounds[t]) / 8);
+        parse_pairs(file.data + bounds[t], file.data + bounds[t + 1], chunks[t]);
+    });
+    return true;
+}
+
+// Read an undirected edge list into a CSR graph. Adjacency is built by a
+// parallel counting sort: atomic degree counts, a prefix sum, an atomic
+// scatter, then per-row sort/dedup and compaction. Returns an empty graph on
+// failure.
+inline Graph read_graph(const std::string& filename, int threads = 0) {
+    threads = resolve_threads(threads);
+    std::vector<std::vector<std::pair<int, int>>> chunks;
+    if (!read_pairs(filename, chunks, threads)) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return Graph();
+    }
+
+    int max_vertex = -1;
+    for (const auto& chunk : chunks) {
+        for (const auto& [u, v] : chunk) max_vertex = std::max({max_vertex, u, v});
+    }
+    int n = max_vertex + 1;
+
+    Graph g;
+    g.n = n;
+    g.label.resize(n);
+    for (int v = 0; v < n; v++) g.label[v] = v;
+    if (n == 0) return g;
+
+    // Count both endpoints of every non-loop edge
+    std::vector<std::atomic<long long>> fill(n);
+    int parts = chunks.size();
+    run_threads(parts, [&](int t) {
+        for (const auto& [u, v] : chunks[t]) {
+            if (u == v || u < 0 || v < 0) continue;
+            fill[u].fetch_add(1, std::memory_order_relaxed);
+            fill[v].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    std::vector<long long> start(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        start[v + 1] = start[v] + fill[v].load(std::memory_order_relaxed);
+        fill[v].store(start[v], std::memory_order_relaxed);
+    }
+
+    // Scatter into raw rows
+    std::vector<int> raw(start[n]);
+    run_threads(parts, [&](int t) {
+        for (const auto& [u, v] : chunks[t]) {
+            if (u == v || u < 0 || v < 0) continue;
+            raw[fill[u].fetch_add(1, std::memory_order_relaxed)] = v;
+            raw[fill[v].fetch_add(1, std::memory_order_relaxed)] = u;
+        }
+    });
+    chunks.clear();
+    chunks.shrink_to_fit();
+
+    // Sort and dedup each row in place, remembering its new length
+    std::vector<long long> kept(n + 1, 0);
+    parallel_for(n, threads, 4096, [&](long long begin, long long end, int) {
+        for (long long v = begin; v < end; v++) {
+            auto first = raw.begin() + start[v], last = raw.begin() + start[v + 1];
+            std::sort(first, last);
+            kept[v + 1] = std::unique(first, last) - first;
+        }
+    });
+    g.offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) g.offsets[v + 1] = g.offsets[v] + kept[v + 1];
+
+    // Compact the deduplicated rows
+    g.nbrs.resize(g.offsets[n]);
+    parallel_for(n, threads, 4096, [&](long long begin, long long end, int) {
+        for (long long v = begin; v < end; v++) {
+            std::copy(raw.begin() + start[v], raw.begin() + start[v] + kept[v + 1], g.nbrs.begin() + g.offsets[v]);
+        }
+    });
+    return g;
+}
+
+} // namespace dsd
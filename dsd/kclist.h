@@ -0,0 +1,613 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "graph.h"
+#include "intersect.h"
+#include "parallel.h"
+#include "profile.h"
+#include "spill.h"
+
+namespace dsd {
+
+// ------------------------ k-Clique Listing (kClist) ------------------------
+//
+// The graph is oriented by a degeneracy order: every edge points from the
+// vertex peeled earlier to the one peeled later, so each out-neighborhood has
+// at most `degeneracy` vertices and every clique is listed exactly once, from
+// its earliest vertex. The recursion only ever intersects the current
+// candidate set with out-neighborhoods, so it never touches non-neighbors.
+//
+// For parallel listing the roots are cut into tasks in sequential order:
+// runs of cheap roots are grouped, and a root whose out-neighborhood is too
+// expensive for one task is split by its second-level branches.
+
+// Roots [root_begin, root_end); for a single split root only branches
+// [branch_begin, branch_end) of its out-row (branch_end == -1: all of them).
+struct CliqueTask {
+    int root_begin, root_end;
+    int branch_begin = 0, branch_end = -1;
+};
+
+struct CliqueLister {
+    int n;
+    int degeneracy;
+    int max_out = 0;
+    std::vector<long long> out_offsets; // out-neighbors in degeneracy orientation,
+    std::vector<int> out;               // CSR rows sorted by id
+
+    CliqueLister(const Graph& g) : n(g.n), out_offsets(g.n + 1, 0) {
+        std::vector<int> order = degeneracy_order(g, degeneracy);
+        std::vector<int> rank(n);
+        for (int i = 0; i < n; i++) rank[order[i]] = i;
+
+        out.reserve(g.num_edges());
+        for (int u = 0; u < n; u++) {
+            // Rows of g are sorted, so the filtered row stays sorted
+            for (int v : g.neighbors(u)) {
+                if (rank[u] < rank[v]) out.push_back(v);
+            }
+            out_offsets[u + 1] = out.size();
+            max_out = std::max(max_out, out_degree(u));
+        }
+    }
+
+    int out_degree(int u) const { return out_offsets[u + 1] - out_offsets[u]; }
+    const int* out_begin(int u) const { return out.data() + out_offsets[u]; }
+
+    // Calls visit(const int* clique) once for every k-clique. The k ids are
+    // in orientation order, not sorted.
+    template <class Visit>
+    void for_each(int k, Visit&& visit) const {
+        Scratch scratch(k, max_out);
+        run(k, CliqueTask{0, n}, scratch, visit);
+    }
+
+    // Cuts the listing into roughly `threads` * 32 tasks of similar cost,
+    // estimated as out_degree^2 per root. Listing the tasks in order lists
+    // the cliques in the same order as for_each.
+    std::vector<CliqueTask> split(int k, int threads) const {
+        std::vector<CliqueTask> tasks;
+        if (threads <= 1 || k < 3) {
+            tasks.push_back({0, n});
+            return tasks;
+        }
+
+        auto cost = [&](int v) -> long long {
+            long long d = out_degree(v);
+            return d < k - 1 ? 0 : d * d;
+        };
+        long long total = 0;
+        for (int v = 0; v < n; v++) total += cost(v);
+        long long target = std::max(1LL, total / (32LL * threads));
+
+        int group = 0;
+        long long acc = 0;
+        for (int v = 0; v < n; v++) {
+            long long c = cost(v);
+            if (c <= target) {
+                acc += c;
+                if (acc >= target) {
+                    tasks.push_back({group, v + 1});
+                    group = v + 1;
+                    acc = 0;
+                }
+                continue;
+            }
+
+            // Heavy root: close the current group, then split v's branches
+            if (group < v) tasks.push_back({group, v});
+            int d = out_degree(v);
+            int pieces = std::min<long long>(d, (c + target - 1) / target);
+            for (int p = 0; p < pieces; p++) {
+                tasks.push_back({v, v + 1, (int)((long long)d * p / pieces), (int)((long long)d * (p + 1) / pieces)});
+            }
+            group = v + 1;
+            acc = 0;
+        }
+        if (group < n) tasks.push_back({group, n});
+        return tasks;
+    }
+
+    // Lists the cliques of `tasks` on `threads` threads with work stealing,
+    // calling visit(const int* clique, int tid, size_t task). Calls for one
+    // task come from one thread, in for_each order.
+    template <class Visit>
+    void for_each_parallel(int k, const std::vector<CliqueTask>& tasks, int threads, Visit&& visit) const {
+        std::vector<Scratch> scratch(std::max(1, threads), Scratch(k, max_out));
+        work_stealing_for(tasks.size(), threads, [&](long long task, int tid) {
+            auto on_clique = [&](const int* c) { visit(c, tid, (size_t)task); };
+            run(k, tasks[task], scratch[tid], on_clique);
+        });
+    }
+
+    // Lists every clique of 1..k vertices in one traversal of `tasks`,
+    // calling visit(const int* clique, int size, int tid, size_t task). A
+    // clique is visited as soon as it appears as a prefix of the recursion,
+    // before its extensions; the split must come from split(k, threads).
+    template <class Visit>
+    void for_each_up_to(int k, const std::vector<CliqueTask>& tasks, int threads, Visit&& visit) const {
+        std::vector<Scratch> scratch(std::max(1, threads), Scratch(k, max_out));
+        work_stealing_for(tasks.size(), threads, [&](long long task, int tid) {
+            auto on_clique = [&](const int* c, int size) { visit(c, size, tid, (size_t)task); };
+            run_up_to(k, tasks[task], scratch[tid], on_clique);
+        });
+    }
+
+private:
+    // Per-thread buffers: the clique under construction, and cand[d] holding
+    // the candidates for position d of the clique
+    struct Scratch {
+        std::vector<int> clique;
+        std::vector<std::vector<int>> cand;
+
+        Scratch(int k, int max_out) : clique(std::max(k, 1)), cand(std::max(k, 1)) {
+            for (int d = 2; d < k; d++) cand[d].resize(max_out);
+        }
+    };
+
+    template <class Visit>
+    void run(int k, const CliqueTask& task, Scratch& scratch, Visit& visit) const {
+        if (k < 1) return;
+        std::vector<int>& clique = scratch.clique;
+        for (int v = task.root_begin; v < task.root_end; v++) {
+            clique[0] = v;
+            if (k == 1) {
+                visit(clique.data());
+                continue;
+            }
+            if (out_degree(v) < k - 1) continue;
+            int len = out_degree(v);
+            int last = task.branch_end < 0 ? len : task.branch_end;
+            extend(k, 1, out_begin(v), len, task.branch_begin, last, clique, scratch.cand, visit);
+        }
+    }
+
+    template <class Visit>
+    void run_up_to(int k, const CliqueTask& task, Scratch& scratch, Visit& visit) const {
+        if (k < 1) return;
+        std::vector<int>& clique = scratch.clique;
+        for (int v = task.root_begin; v < task.root_end; v++) {
+            clique[0] = v;
+            if (task.branch_begin == 0) visit(clique.data(), 1); // once per split root
+            if (k == 1) continue;
+            int len = out_degree(v);
+            int last = task.branch_end < 0 ? len : task.branch_end;
+            extend_up_to(k, 1, out_begin(v), len, task.branch_begin, last, clique, scratch.cand, visit);
+        }
+    }
+
+    // Like extend, but visits every prefix and so can't prune by size.
+    template <class Visit>
+    void extend_up_to(int k, int depth, const int* cur, int len, int first, int last, std::vector<int>& clique,
+                      std::vector<std::vector<int>>& cand, Visit& visit) const {
+        int* next = depth + 1 < k ? cand[depth + 1].data() : nullptr;
+        for (int i = first; i < last; i++) {
+            int u = cur[i];
+            clique[depth] = u;
+            visit(clique.data(), depth + 1);
+            if (depth + 1 == k) continue;
+
+            int m = intersect(cur, len, out_begin(u), out_degree(u), next);
+            if (m > 0) extend_up_to(k, depth + 1, next, m, 0, m, clique, cand, visit);
+        }
+    }
+
+    // Extends the clique with cur[i] for i in [first, last); cur holds every
+    // candidate, since the next level intersects the whole of it.
+    template <class Visit>
+    void extend(int k, int depth, const int* cur, int len, int first, int last, std::vector<int>& clique,
+                std::vector<std::vector<int>>& cand, Visit& visit) const {
+        if (depth == k - 1) {
+            for (int i = first; i < last; i++) {
+                clique[depth] = cur[i];
+                visit(clique.data());
+            }
+            return;
+        }
+
+        int need = k - depth - 1; // vertices still required after this one
+        int* next = cand[depth + 1].data();
+        for (int i = first; i < last; i++) {
+            int u = cur[i];
+            if (out_degree(u) < need) continue;
+
+            // next = cur ∩ out[u]; both sorted by id
+            int m = 0;
+            const int* a = cur;
+            const int* a_end = cur + len;
+            const int* b = out_begin(u);
+            const int* b_end = b + out_degree(u);
+            while (a != a_end && b != b_end) {
+                if (*a < *b) a++;
+                else if (*b < *a) b++;
+                else { next[m++] = *a; a++; b++; }
+            }
+            if (m < need) continue;
+
+            clique[depth] = u;
+            extend(k, depth + 1, next, m, 0, m, clique, cand, visit);
+        }
+    }
+};
+
+// ------------------------ Local Clique Listing ------------------------
+
+// Calls visit(const int* clique) for every k-clique that contains v and lies
+// entirely in alive vertices (clique[0] == v). Used by peeling, where the
+// graph shrinks vertex by vertex and a global orientation would go stale.
+template <class Visit>
+void for_each_clique_containing(const Graph& g, int v, int k, const std::vector<char>& alive, Visit&& visit) {
+    std::vector<int> clique(k);
+    clique[0] = v;
+    if (k == 1) {
+        visit(clique.data());
+        return;
+    }
+
+    std::vector<std::vector<int>> cand(k);
+    for (int u : g.neighbors(v)) {
+        if (alive[u]) cand[1].push_back(u);
+    }
+    for (int d = 2; d < k; d++) cand[d].resize(cand[1].size());
+
+    // Candidates are sorted by id; each level only looks to its right, so
+    // every clique is produced once.
+    auto extend = [&](auto& self, int depth, int len) -> void {
+        const int* cur = cand[depth].data();
+        if (depth == k - 1) {
+            for (int i = 0; i < len; i++) {
+                clique[depth] = cur[i];
+                visit(clique.data());
+            }
+            return;
+        }
+        int need = k - depth - 1;
+        int* next = cand[depth + 1].data();
+        for (int i = 0; i + need < len; i++) {
+            int u = cur[i];
+            Neighbors nu = g.neighbors(u);
+            int m = 0;
+            const int* a = cur + i + 1;
+            const int* a_end = cur + len;
+            const int* b = std::lower_bound(nu.begin(), nu.end(), *a);
+            while (a != a_end && b != nu.end()) {
+                if (*a < *b) a++;
+                else if (*b < *a) b++;
+                else { next[m++] = *a; a++; b++; }
+            }
+            if (m < need) continue;
+            clique[depth] = u;
+            self(self, depth + 1, m);
+        }
+    };
+    extend(extend, 1, cand[1].size());
+}
+
+// ------------------------ Streaming Clique Consumers ------------------------
+
+// Flat fixed-stride clique buffer: clique i occupies ids[i*k .. i*k+k), or
+// the same range of the mapped `file` once the store was spilled.
+struct CliqueStore {
+    int k;
+    std::vector<int> ids;
+    std::shared_ptr<SpillFile> file; // read-only once set, so copies share it
+    size_t spilled = 0;              // cliques in `file`
+
+    CliqueStore(int k = 0) : k(k) {}
+
+    size_t size() const { return file ? spilled : k ? ids.size() / k : 0; }
+    bool empty() const { return size() == 0; }
+    const int* data() const { return file ? static_cast<const int*>(file->data()) : ids.data(); }
+    const int* operator[](size_t i) const { return data() + i * k; }
+    void push(const int* clique) { ids.insert(ids.end(), clique, clique + k); }
+
+    // Call after a pass over a spilled store; a no-op in memory.
+    void release() const {
+        if (file) file->release();
+    }
+};
+
+// Gathers the k-cliques of a parallel listing into a store in task order.
+// Every task fills its own buffer. Under a memory budget a buffer is written
+// to a scratch file once it reaches its share of the budget, and so is a
+// finished task's buffer while the buffers together hold more than half of
+// it; finish() then copies the chunks into one file in task order and maps
+// it. Whatever can't be written stays in memory.
+class CliqueCollector {
+public:
+    CliqueCollector(int k, size_t tasks, int threads, const SpillPolicy& spill)
+        : k(k), dir(spill.dir), budget(spill.memory_budget), parts(tasks), chunks(tasks), current(threads, -1) {
+        if (budget) {
+            chunk_bytes = std::max<size_t>(budget / (2 * threads), 1 << 16);
+            scratch = std::make_unique<SpillFile>(dir);
+            if (!scratch->ok()) budget = 0;
+        }
+    }
+
+    // Calls for one task must come from one thread, as in for_each_parallel.
+    void push(const int* clique, int tid, size_t task) {
+        if (current[tid] != (long long)task) {
+            if (budget && current[tid] >= 0 && held > budget / 2) flush(current[tid]);
+            current[tid] = task;
+        }
+        std::vector<int>& part = parts[task];
+        part.insert(part.end(), clique, clique + k);
+        if (budget) {
+            held += k * sizeof(int);
+            if (part.size() * sizeof(int) >= chunk_bytes) flush(task);
+        }
+    }
+
+    CliqueStore finish() {
+        CliqueStore store(k);
+        bool spilled = false;
+        for (const auto& c : chunks) spilled = spilled || !c.empty();
+        if (spilled) {
+            auto out = std::make_shared<SpillFile>(dir);
+            if (copy_out(*out) && out->map()) {
+                store.file = out;
+                store.spilled = out->size() / (k * sizeof(int));
+                return store;
+            }
+            // No room on disk after all: read the chunks back into memory
+            for (size_t task = 0; task < chunks.size(); task++) {
+                std::vector<int> part;
+                for (const Chunk& c : chunks[task]) {
+                    part.resize(part.size() + c.bytes / sizeof(int));
+                    scratch->read(c.offset, part.data() + part.size() - c.bytes / sizeof(int), c.bytes);
+                }
+                part.insert(part.end(), parts[task].begin(), parts[task].end());
+                parts[task] = std::move(part);
+            }
+        }
+
+        if (parts.size() == 1) {
+            store.ids = std::move(parts[0]);
+        } else {
+            size_t total = 0;
+            for (const auto& p : parts) total += p.size();
+            store.ids.reserve(total);
+            for (auto& p : parts) {
+                store.ids.insert(store.ids.end(), p.begin(), p.end());
+                p = std::vector<int>();
+            }
+        }
+        return store;
+    }
+
+private:
+    struct Chunk {
+        size_t offset, bytes;
+    };
+
+    int k;
+    std::string dir;
+    size_t budget;
+    size_t chunk_bytes = 0;
+    std::unique_ptr<SpillFile> scratch;
+    std::vector<std::vector<int>> parts;
+    std::vector<std::vector<Chunk>> chunks;
+    std::vector<long long> current; // task each thread is on
+    std::atomic<size_t> held{0};    // bytes in `parts`
+
+    void flush(size_t task) {
+        std::vector<int>& part = parts[task];
+        size_t bytes = part.size() * sizeof(int);
+        if (bytes == 0) return;
+        long long offset = scratch->append(part.data(), bytes);
+        if (offset < 0) return;
+        profile::count(profile::SPILLED_BYTES, bytes);
+        chunks[task].push_back({(size_t)offset, bytes});
+        held -= bytes;
+        part = std::vector<int>();
+    }
+
+    // Chunks and leftover buffers, task by task, through one bounded buffer
+    bool copy_out(SpillFile& out) {
+        std::vector<char> buffer(std::min<size_t>(chunk_bytes, 1 << 20));
+        for (size_t task = 0; task < chunks.size(); task++) {
+            for (const Chunk& c : chunks[task]) {
+                for (size_t done = 0; done < c.bytes; done += buffer.size()) {
+                    size_t n = std::min(buffer.size(), c.bytes - done);
+                    if (!scratch->read(c.offset + done, buffer.data(), n) || out.append(buffer.data(), n) < 0) {
+                        return false;
+                    }
+                }
+            }
+            std::vector<int>& part = parts[task];
+            if (!part.empty() && out.append(part.data(), part.size() * sizeof(int)) < 0) return false;
+        }
+        return true;
+    }
+};
+
+// Per-vertex k-clique degrees in O(n) memory per thread; returns the clique
+// count. Each thread accumulates privately and the arrays are summed at the
+// end, so the result doesn't depend on scheduling.
+inline long long clique_degrees(const CliqueLister& lister, int k, std::vector<long long>& deg, int threads = 1) {
+    threads = resolve_threads(threads);
+    std::vector<CliqueTask> tasks = lister.split(k, threads);
+    threads = std::max(1, std::min<int>(threads, tasks.size()));
+
+    std::vector<std::vector<long long>> local(threads, std::vector<long long>(lister.n, 0));
+    std::vector<long long> counts(threads, 0);
+    lister.for_each_parallel(k, tasks, threads, [&](const int* c, int tid, size_t) {
+        for (int i = 0; i < k; i++) local[tid][c[i]]++;
+        counts[tid]++;
+    });
+
+    deg = std::move(local[0]);
+    for (int t = 1; t < threads; t++) {
+        for (int v = 0; v < lister.n; v++) deg[v] += local[t][v];
+    }
+    long long count = 0;
+    for (long long c : counts) count += c;
+    profile::count(profile::CLIQUES_LISTED, count);
+    return count;
+}
+
+inline long long count_cliques(const CliqueLister& lister, int k, int threads = 1) {
+    threads = resolve_threads(threads);
+    std::vector<CliqueTask> tasks = lister.split(k, threads);
+    std::vector<long long> counts(threads, 0);
+    lister.for_each_parallel(k, tasks, threads, [&](const int*, int tid, size_t) { counts[tid]++; });
+
+    long long count = 0;
+    for (long long c : counts) count += c;
+    profile::count(profile::CLIQUES_LISTED, count);
+    return count;
+}
+
+// Stores every k-clique, optionally accumulating degrees in the same pass.
+// Every task fills its own buffer and the buffers are concatenated in task
+// order, so the store matches the sequential listing exactly. Beyond
+// spill.memory_budget bytes the store is spilled to disk (CliqueCollector).
+inline CliqueStore collect_cliques(const CliqueLister& lister, int k, std::vector<long long>* deg = nullptr, int threads = 1,
+                                   const SpillPolicy& spill = SpillPolicy()) {
+    threads = resolve_threads(threads);
+    std::vector<CliqueTask> tasks = lister.split(k, threads);
+    threads = std::max(1, std::min<int>(threads, tasks.size()));
+
+    CliqueCollector collector(k, tasks.size(), threads, spill);
+    std::vector<std::vector<long long>> local(deg ? threads : 0, std::vector<long long>(lister.n, 0));
+    lister.for_each_parallel(k, tasks, threads, [&](const int* c, int tid, size_t task) {
+        collector.push(c, tid, task);
+        if (deg) {
+            for (int i = 0; i < k; i++) local[tid][c[i]]++;
+        }
+    });
+    CliqueStore store = collector.finish();
+
+    if (deg) {
+        *deg = std::move(local[0]);
+        for (int t = 1; t < threads; t++) {
+            for (int v = 0; v < lister.n; v++) (*deg)[v] += local[t][v];
+        }
+    }
+    profile::count(profile::CLIQUES_LISTED, store.size());
+    return store;
+}
+
+// Every clique size up to k from one traversal: count[j] for j-cliques
+// (2 <= j <= k), degree[j][v] for the sizes from `degrees_from` on, and
+// store[j] holding the j-cliques for the sizes with keep[j] set. With up to
+// k levels, per-thread degree arrays would cost threads * k * n counters, so
+// the threads add into one shared atomic array per level instead. Stores are
+// collected in task order, as in the single-size consumers; the kept sizes
+// share the spill budget evenly.
+struct CliqueLevels {
+    std::vector<long long> count;
+    std::vector<std::vector<long long>> degree;
+    std::vector<CliqueStore> store;
+};
+
+inline CliqueLevels clique_levels(const CliqueLister& lister, int k, const std::vector<char>& keep, int threads = 1,
+                                  const SpillPolicy& spill = SpillPolicy(), int degrees_from = 2) {
+    threads = resolve_threads(threads);
+    std::vector<CliqueTask> tasks = lister.split(k, threads);
+    threads = std::max(1, std::min<int>(threads, tasks.size()));
+
+    CliqueLevels levels;
+    levels.count.assign(k + 1, 0);
+    levels.degree.assign(k + 1, {});
+    levels.store.resize(k + 1);
+    for (int j = 2; j <= k; j++) levels.store[j] = CliqueStore(j);
+
+    degrees_from = std::max(degrees_from, 2);
+    std::vector<std::vector<std::atomic<long long>>> shared(k + 1);
+    for (int j = degrees_from; j <= k; j++) shared[j] = std::vector<std::atomic<long long>>(lister.n);
+    std::vector<std::vector<long long>> counts(threads, std::vector<long long>(k + 1, 0));
+
+    auto kept = [&](int j) { return j >= 2 && j < (int)keep.size() && keep[j]; };
+    SpillPolicy share = spill;
+    int num_kept = 0;
+    for (int j = 2; j <= k; j++) num_kept += kept(j);
+    if (num_kept) share.memory_budget /= num_kept;
+    std::vector<std::unique_ptr<CliqueCollector>> collectors(k + 1);
+    for (int j = 2; j <= k; j++) {
+        if (kept(j)) collectors[j] = std::make_unique<CliqueCollector>(j, tasks.size(), threads, share);
+    }
+
+    lister.for_each_up_to(k, tasks, threads, [&](const int* c, int size, int tid, size_t task) {
+        if (size < 2) return;
+        if (size >= degrees_from) {
+            for (int i = 0; i < size; i++) shared[size][c[i]].fetch_add(1, std::memory_order_relaxed);
+        }
+        counts[tid][size]++;
+        if (collectors[size]) collectors[size]->push(c, tid, task);
+    });
+
+    for (int j = 2; j <= k; j++) {
+        if (j >= degrees_from) {
+            levels.degree[j].resize(lister.n);
+            for (int v = 0; v < lister.n; v++) levels.degree[j][v] = shared[j][v].load(std::memory_order_relaxed);
+            shared[j] = std::vector<std::atomic<long long>>();
+        }
+        for (int t = 0; t < threads; t++) levels.count[j] += counts[t][j];
+        profile::count(profile::CLIQUES_LISTED, levels.count[j]);
+        if (collectors[j]) levels.store[j] = collectors[j]->finish();
+    }
+    return levels;
+}
+
+// ------------------------ Clique Extensions ------------------------
+
+// For every clique of a store, the vertices adjacent to all of its members
+// (those that extend it to a (k+1)-clique), in one CSR array: clique i's
+// extensions are ids[offsets[i] .. offsets[i+1]), sorted ascending.
+struct CliqueExtensions {
+    std::vector<long long> offsets{0};
+    std::vector<int> ids;
+
+    size_t size() const { return offsets.size() - 1; }
+    Neighbors operator[](size_t i) const { return {ids.data() + offsets[i], ids.data() + offsets[i + 1]}; }
+};
+
+// Intersects the members' neighbor lists, smallest first. Blocks of cliques
+// are handled in parallel into private buffers, then concatenated in order.
+inline CliqueExtensions clique_extensions(const Graph& g, const CliqueStore& store, int threads = 1) {
+    threads = resolve_threads(threads);
+    size_t m = store.size();
+    int k = store.k;
+    const long long grain = 1024;
+    long long blocks = (m + grain - 1) / grain;
+    int max_degree = g.max_degree();
+
+    CliqueExtensions ext;
+    ext.offsets.assign(m + 1, 0);
+    std::vector<std::vector<int>> parts(blocks);
+    parallel_for(blocks, threads, 1, [&](long long begin, long long end, int) {
+        std::vector<int> order(k), buf(max_degree);
+        for (long long b = begin; b < end; b++) {
+            size_t first = b * grain, last = std::min<size_t>(m, first + grain);
+            for (size_t i = first; i < last; i++) {
+                const int* c = store[i];
+                order.assign(c, c + k);
+                std::sort(order.begin(), order.end(), [&](int x, int y) { return g.degree(x) < g.degree(y); });
+
+                Neighbors smallest = g.neighbors(order[0]);
+                int len = std::copy(smallest.begin(), smallest.end(), buf.begin()) - buf.begin();
+                for (int j = 1; j < k && len > 0; j++) {
+                    Neighbors nj = g.neighbors(order[j]);
+                    len = intersect(buf.data(), len, nj.begin(), nj.size(), buf.data());
+                }
+                parts[b].insert(parts[b].end(), buf.begin(), buf.begin() + len);
+                ext.offsets[i + 1] = len;
+            }
+        }
+    });
+
+    for (size_t i = 0; i < m; i++) ext.offsets[i + 1] += ext.offsets[i];
+    ext.ids.reserve(ext.offsets[m]);
+    for (auto& p : parts) {
+        ext.ids.insert(ext.ids.end(), p.begin(), p.end());
+        p = std::vector<int>();
+    }
+    return ext;
+}
+
+} // namespace dsd
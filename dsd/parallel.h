@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dsd {
+
+// ------------------------ Thread Helpers ------------------------
+
+// Resolves a requested thread count; 0 means one per hardware thread.
+inline int resolve_threads(int requested) {
+    if (requested > 0) return requested;
+    int hw = std::thread::hardware_concurrency();
+    return std::max(1, hw);
+}
+
+// Runs fn(tid) on `threads` threads (the caller runs tid 0) and joins them.
+template <class Fn>
+void run_threads(int threads, Fn&& fn) {
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back([&fn, t] { fn(t); });
+    fn(0);
+    for (auto& th : pool) th.join();
+}
+
+// Dynamically scheduled loop over [0, n) in blocks of `grain`:
+// fn(begin, end, tid) is called for each block.
+template <class Fn>
+void parallel_for(long long n, int threads, long long grain, Fn&& fn) {
+    if (n <= 0) return;
+    threads = std::max(1, (int)std::min<long long>(threads, (n + grain - 1) / grain));
+    std::atomic<long long> next(0);
+    run_threads(threads, [&](int tid) {
+        while (true) {
+            long long begin = next.fetch_add(grain);
+            if (begin >= n) break;
+            fn(begin, std::min(n, begin + grain), tid);
+        }
+    });
+}
+
+// Runs fn(task, tid) for every task in [0, n) with work stealing. Each
+// thread starts on its own contiguous block of tasks and works through it
+// front to back; a thread that runs dry takes the back half of another
+// thread's remaining block. Suits tasks of very uneven cost that don't
+// spawn further tasks.
+template <class Fn>
+void work_stealing_for(long long n, int threads, Fn&& fn) {
+    if (n <= 0) return;
+    threads = std::max(1, (int)std::min<long long>(threads, n));
+
+    struct Block {
+        std::mutex mu;
+        long long begin = 0, end = 0;
+    };
+    std::vector<Block> blocks(threads);
+    for (int t = 0; t < threads; t++) {
+        blocks[t].begin = n * t / threads;
+        blocks[t].end = n * (t + 1) / threads;
+    }
+
+    run_threads(threads, [&](int tid) {
+        Block& own = blocks[tid];
+        while (true) {
+            long long task = -1;
+            {
+                std::lock_guard<std::mutex> lock(own.mu);
+                if (own.begin < own.end) task = own.begin++;
+            }
+            if (task >= 0) {
+                fn(task, tid);
+                continue;
+            }
+
+            // Steal the back half of the first non-empty block
+            bool stolen = false;
+            for (int i = 1; i < threads && !stolen; i++) {
+                Block& victim = blocks[(tid + i) % threads];
+                long long begin, end;
+                {
+                    std::lock_guard<std::mutex> lock(victim.mu);
+                    long long left = victim.end - victim.begin;
+                    if (left <= 0) continue;
+                    end = victim.end;
+                    begin = victim.end - (left + 1) / 2;
+                    victim.end = begin;
+                }
+                std::lock_guard<std::mutex> lock(own.mu);
+                own.begin = begin;
+                own.end = end;
+                stolen = true;
+            }
+            if (!stolen) break; // tasks never spawn tasks, so everything is taken
+        }
+    });
+}
+
+// Reusable barrier for the threads of one run_threads call.
+struct Barrier {
+    explicit Barrier(int count) : count(count) {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mu);
+        long long gen = generation;
+        if (++arrived == count) {
+            arrived = 0;
+            generation++;
+            cv.notify_all();
+        } else {
+            cv.wait(lock, [&] { return generation != gen; });
+        }
+    }
+
+private:
+    std::mutex mu;
+    std::condition_variable cv;
+    int count;
+    int arrived = 0;
+    long long generation = 0;
+};
+
+} // namespace dsd
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+#include "kclist.h"
+
+namespace dsd {
+
+// ------------------------ Monotone Bucket Queue ------------------------
+//
+// Radix heap: bucket i holds keys that first differ from the last extracted
+// key in bit i-1, so 65 buckets cover any 64-bit key range and each entry
+// moves down at most 64 times. Keys may not be smaller than the last
+// extracted one; pushes below it are raised to it. Entries are never
+// removed, so callers skip stale ones.
+
+struct BucketQueue {
+    typedef std::pair<unsigned long long, int> Entry;
+
+    BucketQueue() : buckets(65) {}
+
+    bool empty() const { return size == 0; }
+    unsigned long long level() const { return last; }
+
+    // Returns the key actually stored (at least level()).
+    unsigned long long push(unsigned long long key, int v) {
+        key = std::max(key, last);
+        buckets[index(key)].push_back({key, v});
+        size++;
+        return key;
+    }
+
+    Entry pop() {
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) i++;
+            unsigned long long lo = buckets[i][0].first;
+            for (const Entry& e : buckets[i]) lo = std::min(lo, e.first);
+            last = lo;
+            for (const Entry& e : buckets[i]) buckets[index(e.first)].push_back(e);
+            buckets[i].clear();
+        }
+        Entry e = buckets[0].back();
+        buckets[0].pop_back();
+        size--;
+        return e;
+    }
+
+private:
+    std::vector<std::vector<Entry>> buckets;
+    unsigned long long last = 0;
+    long long size = 0;
+
+    int index(unsigned long long key) const {
+        return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+    }
+};
+
+// ------------------------ h-Clique Peel ------------------------
+//
+// Repeatedly remove the vertex of minimum key, key = load + remaining clique
+// degree, decrementing the other members of every clique it still belongs
+// to. The level is the largest degree at removal so far; without a load it
+// is each vertex's clique-core number, since a key that falls below the
+// level is taken at the level. The removal order and the densest suffix of
+// it are kept; `load`, if given, gains each vertex's degree at removal.
+
+struct CliquePeel {
+    std::vector<int> order;      // removal order
+    std::vector<long long> core; // level at each vertex's removal
+    long long kmax = 0;          // final level
+    int best_pos = 0;            // densest suffix: order[best_pos..]
+    long long best_cliques = 0;  // h-cliques inside it
+    double best = 0;
+};
+
+inline CliquePeel peel_cliques(const Graph& g, int h, std::vector<long long> deg,
+                               std::vector<unsigned long long>* load = nullptr) {
+    int n = g.n;
+    CliquePeel peel;
+    peel.core.assign(n, 0);
+    peel.order.reserve(n);
+
+    long long cliques = 0;
+    for (long long d : deg) cliques += d;
+    cliques /= h;
+    peel.best_cliques = cliques;
+    peel.best = n ? (double)cliques / n : 0;
+
+    auto key_of = [&](int v) { return (load ? (*load)[v] : 0) + (unsigned long long)deg[v]; };
+    std::vector<unsigned long long> key(n);
+    std::vector<char> alive(n, 1);
+    BucketQueue queue;
+    for (int v = 0; v < n; v++) key[v] = queue.push(key_of(v), v);
+
+    long long level = 0;
+    while (!queue.empty()) {
+        auto [k, v] = queue.pop();
+        if (!alive[v] || k != key[v]) continue; // stale entry
+
+        level = std::max(level, deg[v]);
+        peel.core[v] = level;
+        alive[v] = 0;
+        peel.order.push_back(v);
+        if (load) (*load)[v] += deg[v];
+        cliques -= deg[v];
+
+        if (deg[v] > 0) {
+            for_each_clique_containing(g, v, h, alive, [&](const int* c) {
+                for (int i = 1; i < h; i++) {
+                    int u = c[i];
+                    deg[u]--;
+                    key[u] = queue.push(key_of(u), u);
+                }
+            });
+        }
+
+        int left = n - peel.order.size();
+        if (left > 0 && (double)cliques / left > peel.best) {
+            peel.best = (double)cliques / left;
+            peel.best_cliques = cliques;
+            peel.best_pos = peel.order.size();
+        }
+    }
+    peel.kmax = level;
+    return peel;
+}
+
+// ------------------------ Peeling Approximation ------------------------
+//
+// CoreApp: peel once and keep the densest suffix. The remaining graph at the
+// moment the level reaches kmax is the (kmax,Ψ)-core, of density at least
+// kmax/h >= ρ*/h, so the answer is a 1/h-approximation and kmax is an upper
+// bound on ρ*. The first pass also yields the clique-core numbers.
+//
+// Greedy++ repeats the peel with every vertex keyed by its clique degree
+// plus a load: the sum of its degrees at removal in earlier passes. Later
+// passes spread out the vertices the first one removed too early, and the
+// best suffix over all passes is kept. A vertex whose key falls below the
+// current level is taken at the level, which is what peeling by core number
+// does anyway.
+
+struct PeelResult {
+    std::vector<int> vertices;  // densest suffix found, ids of the graph
+    long long cliques = 0;      // h-cliques inside it
+    double density = 0;
+    long long kmax = 0;         // upper bound on ρ* from the first pass
+    std::vector<long long> core; // clique-core numbers from the first pass
+    int passes = 0;
+};
+
+inline PeelResult peel_densest(const Graph& g, int h, int passes = 1, int threads = 1) {
+    int n = g.n;
+    PeelResult result;
+    result.core.assign(n, 0);
+    std::vector<long long> initial;
+    long long total = clique_degrees(CliqueLister(g), h, initial, threads);
+    if (total == 0 || n == 0) return result;
+
+    std::vector<unsigned long long> load(n, 0);
+    for (int pass = 0; pass < std::max(passes, 1); pass++) {
+        CliquePeel peel = peel_cliques(g, h, initial, &load);
+        if (pass == 0) {
+            result.kmax = peel.kmax;
+            result.core = std::move(peel.core);
+        }
+        if (pass == 0 || peel.best > result.density) {
+            result.density = peel.best;
+            result.vertices.assign(peel.order.begin() + peel.best_pos, peel.order.end());
+            result.cliques = peel.best_cliques;
+        }
+        result.passes++;
+    }
+    std::sort(result.vertices.begin(), result.vertices.end());
+    return result;
+}
+
+} // namespace dsd
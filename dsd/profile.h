@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dsd {
+namespace profile {
+
+// ------------------------ Phase Timers and Counters ------------------------
+//
+// Process-wide instrumentation, off unless a program calls enable(). Scoped
+// timers add their elapsed time to a named phase, counters are relaxed
+// atomics, and an optional trace keeps one record per search iteration.
+// Every entry point tests a single flag first, so a disabled build pays one
+// predictable branch per call; hot loops count into locals and report once
+// per call rather than per event. Phases are flat: a timer nested inside
+// another phase's timer is counted in both.
+
+enum Counter {
+    CLIQUES_LISTED,   // cliques visited by the listing consumers
+    ARCS,             // arcs in every flow network built
+    NETWORK_BYTES,    // memory of every flow network built
+    MAX_FLOWS,        // max-flow calls
+    BFS_PHASES,       // Dinic level graphs
+    AUGMENTING_PATHS, // Dinic augmenting paths
+    PUSHES,           // push-relabel pushes
+    RELABELS,         // push-relabel relabels
+    GLOBAL_RELABELS,  // push-relabel global relabels
+    SPILLED_BYTES,    // clique bytes spilled past the memory budget
+    NUM_COUNTERS
+};
+
+inline const char* counter_name(Counter c) {
+    static const char* names[NUM_COUNTERS] = {
+        "cliques_listed", "arcs", "network_bytes", "max_flows", "bfs_phases",
+        "augmenting_paths", "pushes", "relabels", "global_relabels", "spilled_bytes",
+    };
+    return names[c];
+}
+
+struct Phase {
+    std::string name;
+    double seconds = 0;
+    long long calls = 0;
+};
+
+struct State {
+    bool enabled = false;
+    bool tracing = false;
+    std::atomic<long long> counters[NUM_COUNTERS] = {};
+    std::mutex lock; // guards phases and trace
+    std::vector<Phase> phases;
+    std::vector<std::vector<std::pair<std::string, double>>> trace;
+    long long traced[NUM_COUNTERS] = {}; // counters at the last trace record
+};
+
+inline State& state() {
+    static State s;
+    return s;
+}
+
+inline void enable(bool tracing = false) {
+    state().enabled = true;
+    state().tracing = tracing;
+}
+
+inline bool enabled() { return state().enabled; }
+
+inline void count(Counter c, long long n = 1) {
+    if (state().enabled) state().counters[c].fetch_add(n, std::memory_order_relaxed);
+}
+
+inline long long counter(Counter c) { return state().counters[c].load(std::memory_order_relaxed); }
+
+inline void add_phase(const char* name, double seconds) {
+    State& s = state();
+    std::lock_guard<std::mutex> guard(s.lock);
+    for (Phase& p : s.phases) {
+        if (p.name == name) {
+            p.seconds += seconds;
+            p.calls++;
+            return;
+        }
+    }
+    s.phases.push_back({name, seconds, 1});
+}
+
+// Times the enclosing scope, or up to stop(), into phase `name`.
+struct Scope {
+    explicit Scope(const char* name) : name(name), on(state().enabled) {
+        if (on) start = std::chrono::steady_clock::now();
+    }
+
+    ~Scope() { stop(); }
+
+    void stop() {
+        if (!on) return;
+        on = false;
+        std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+        add_phase(name, d.count());
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name;
+    bool on;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Appends one iteration record, e.g. trace({{"iteration", 3}, {"flow", f}}),
+// followed by every counter that moved since the previous record.
+inline void trace(std::initializer_list<std::pair<const char*, double>> fields) {
+    State& s = state();
+    if (!s.tracing) return;
+    std::vector<std::pair<std::string, double>> row;
+    for (const auto& [key, value] : fields) row.push_back({key, value});
+    std::lock_guard<std::mutex> guard(s.lock);
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+        long long now = counter((Counter)c);
+        if (now != s.traced[c]) row.push_back({counter_name((Counter)c), (double)(now - s.traced[c])});
+        s.traced[c] = now;
+    }
+    s.trace.push_back(std::move(row));
+}
+
+// One-line JSON summary:
+// {"phases": {"name": {"seconds": x, "calls": n}, ...}, "counters": {...}, "trace": [...]}
+inline void write_json(std::ostream& out) {
+    State& s = state();
+    std::lock_guard<std::mutex> guard(s.lock);
+    auto number = [&](double x) {
+        if (x == (long long)x) out << (long long)x;
+        else out << x;
+    };
+
+    out << "{\"phases\": {";
+    for (size_t i = 0; i < s.phases.size(); i++) {
+        out << (i ? ", " : "") << "\"" << s.phases[i].name << "\": {\"seconds\": ";
+        number(s.phases[i].seconds);
+        out << ", \"calls\": " << s.phases[i].calls << "}";
+    }
+    out << "}, \"counters\": {";
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+        out << (c ? ", " : "") << "\"" << counter_name((Counter)c) << "\": " << counter((Counter)c);
+    }
+    out << "}";
+    if (s.tracing) {
+        out << ", \"trace\": [";
+        for (size_t i = 0; i < s.trace.size(); i++) {
+            out << (i ? ", " : "") << "{";
+            for (size_t j = 0; j < s.trace[i].size(); j++) {
+                out << (j ? ", " : "") << "\"" << s.trace[i][j].first << "\": ";
+                number(s.trace[i][j].second);
+            }
+            out << "}";
+        }
+        out << "]";
+    }
+    out << "}" << std::endl;
+}
+
+// Writes the summary to `file`, or to stdout for "-"; nothing if empty.
+inline void write_json(const std::string& file) {
+    if (file.empty()) return;
+    if (file == "-") {
+        write_json(std::cout);
+        return;
+    }
+    std::ofstream out(file);
+    write_json(out);
+}
+
+} // namespace profile
+} // namespace dsd
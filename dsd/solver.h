@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "core_exact.h"
+#include "exact.h"
+#include "flow.h"
+#include "frank_wolfe.h"
+#include "graph.h"
+#include "kclist.h"
+#include "parallel.h"
+#include "peel.h"
+#include "profile.h"
+
+namespace dsd {
+
+// ------------------------ Solver Interface ------------------------
+//
+// One entry point over every algorithm in the library, for embedding the
+// solver without going through the command-line programs:
+//
+//   dsd::Graph g = dsd::read_graph("edges.txt");
+//   dsd::SolverOptions opt;
+//   opt.h = 3;
+//   opt.algorithm = "core-exact";
+//   dsd::SolverResult r = dsd::solve(g, opt);
+//
+// exact:       Algorithm 1, the flow network on (h-1)-cliques
+// core-exact:  Algorithm 4, the flow search confined to (k,Ψ)-cores
+// approx:      peeling (CoreApp, Greedy++ with passes > 1); density >= ρ*/h
+// frank-wolfe: load balancing over the h-cliques, converging to ρ*
+//
+// The SearchOptions fields tune the flow-based algorithms; fields that don't
+// apply to the chosen algorithm are ignored. Progress goes to `log` if set.
+
+struct SolverOptions : SearchOptions {
+    std::string algorithm = "core-exact";
+    int fw_iterations = 100; // frank-wolfe: iteration limit
+    double fw_gap = 1e-3;    // frank-wolfe: stop at this relative gap
+
+    SolverOptions() { threads = 0; } // 0 = all hardware threads
+};
+
+struct SolverStats {
+    int iterations = 0;     // flow searches, Frank-Wolfe steps or peeling passes
+    double upper_bound = 0; // certified bound on ρ*; the density itself when exact
+    long long kmax = 0;     // largest (k,Ψ)-core number (core-exact, approx)
+    int components = 0;     // core-exact with components
+    int pruned = 0;
+    double seconds = 0;
+};
+
+struct SolverResult {
+    std::vector<int> vertices; // sorted ids of the graph; empty if it has no h-clique
+    long long cliques = 0;     // h-cliques inside it
+    double density = 0;
+    SolverStats stats;
+    std::string error;         // set instead of solving if the options are invalid
+};
+
+inline bool valid_algorithm(const std::string& algorithm) {
+    return algorithm == "exact" || algorithm == "core-exact" || algorithm == "approx" || algorithm == "frank-wolfe";
+}
+
+// Empty if `opt` is usable, otherwise what is wrong with it.
+inline std::string check_options(const SolverOptions& opt) {
+    if (opt.h < 2) return "h must be at least 2";
+    if (!valid_algorithm(opt.algorithm)) {
+        return "unknown algorithm " + opt.algorithm + " (use exact, core-exact, approx or frank-wolfe)";
+    }
+    if (!valid_flow_engine(opt.flow_engine)) {
+        return "unknown max-flow engine " + opt.flow_engine + " (use dinic or push-relabel)";
+    }
+    if (opt.search != "dinkelbach" && opt.search != "bisect") {
+        return "unknown search " + opt.search + " (use dinkelbach or bisect)";
+    }
+    return "";
+}
+
+inline SolverResult solve(const Graph& g, const SolverOptions& options) {
+    SolverResult result;
+    result.error = check_options(options);
+    if (!result.error.empty()) return result;
+
+    SolverOptions opt = options;
+    opt.threads = resolve_threads(opt.threads);
+    int h = opt.h;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (opt.algorithm == "approx") {
+        profile::Scope phase("approx");
+        PeelResult peel = peel_densest(g, h, opt.passes, opt.threads);
+        result.vertices = std::move(peel.vertices);
+        result.cliques = peel.cliques;
+        result.density = peel.density;
+        result.stats.iterations = peel.passes;
+        result.stats.kmax = peel.kmax;
+        // The peel is an h-approximation, which is usually tighter than kmax
+        result.stats.upper_bound = std::min((double)peel.kmax, h * peel.density);
+    } else if (opt.algorithm == "frank-wolfe") {
+        profile::Scope phase("frank_wolfe");
+        FrankWolfeResult fw = frank_wolfe_densest(g, h, opt.fw_iterations, opt.fw_gap, opt.threads, opt.spill);
+        result.vertices = std::move(fw.vertices);
+        result.cliques = fw.cliques;
+        result.density = fw.density;
+        result.stats.iterations = fw.iterations;
+        result.stats.upper_bound = fw.upper;
+    } else {
+        SearchResult search = opt.algorithm == "exact" ? exact_densest(g, opt) : core_exact_densest(g, opt);
+        result.vertices = std::move(search.vertices);
+        result.stats.iterations = search.iterations;
+        result.stats.kmax = search.kmax;
+        result.stats.components = search.components;
+        result.stats.pruned = search.pruned;
+
+        if (!result.vertices.empty()) {
+            profile::Scope phase("verification");
+            result.cliques = count_cliques(CliqueLister(induced_subgraph(g, result.vertices)), h, opt.threads);
+            result.density = (double)result.cliques / result.vertices.size();
+        }
+        result.stats.upper_bound = result.density;
+    }
+
+    std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+    result.stats.seconds = duration.count();
+    return result;
+}
+
+// solve() for every h in [lo, hi], indexed by h - lo. The exact algorithm
+// shares one clique traversal across all of them (exact_densest_range), with
+// the searches run concurrently if `parallel_h`; the others solve each h on
+// its own. opt.h is ignored.
+inline std::vector<SolverResult> solve_range(const Graph& g, int lo, int hi, const SolverOptions& options,
+                                             bool parallel_h = false) {
+    SolverOptions opt = options;
+    opt.h = lo;
+    std::vector<SolverResult> results(std::max(0, hi - lo + 1));
+    std::string error = check_options(opt);
+    if (!error.empty()) {
+        for (auto& r : results) r.error = error;
+        return results;
+    }
+    if (opt.algorithm != "exact") {
+        for (int h = lo; h <= hi; h++) {
+            opt.h = h;
+            results[h - lo] = solve(g, opt);
+        }
+        return results;
+    }
+
+    opt.threads = resolve_threads(opt.threads);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<SearchResult> searches = exact_densest_range(g, lo, hi, opt, parallel_h);
+    for (int h = lo; h <= hi; h++) {
+        SolverResult& result = results[h - lo];
+        SearchResult& search = searches[h - lo];
+        result.vertices = std::move(search.vertices);
+        result.stats.iterations = search.iterations;
+        if (!result.vertices.empty()) {
+            profile::Scope phase("verification");
+            result.cliques = count_cliques(CliqueLister(induced_subgraph(g, result.vertices)), h, opt.threads);
+            result.density = (double)result.cliques / result.vertices.size();
+        }
+        result.stats.upper_bound = result.density;
+    }
+
+    // The listing is shared, so every h reports the time of the whole batch
+    std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+    for (auto& r : results) r.stats.seconds = duration.count();
+    return results;
+}
+
+} // namespace dsd
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace dsd {
+
+// ------------------------ Disk Spill ------------------------
+//
+// Large clique stores can live in a file instead of memory: they are written
+// in chunks while the listing runs and read back through a read-only
+// mapping. The kernel pages the mapping in with sequential read-ahead and can
+// drop clean pages under memory pressure, so the store no longer counts
+// against the resident set the way a heap buffer does.
+
+// memory_budget: bytes of cliques kept in memory before spilling (0: never
+// spill). dir: where spill files go (empty: $TMPDIR, else /tmp).
+struct SpillPolicy {
+    size_t memory_budget = 0;
+    std::string dir;
+};
+
+// An anonymous temporary file: it is unlinked as soon as it is created, so
+// it disappears with the process however that ends. Appends may come from
+// several threads at once. All calls report failure instead of throwing; a
+// failed file stays failed.
+class SpillFile {
+public:
+    explicit SpillFile(const std::string& dir) {
+        std::string base = dir;
+        if (base.empty()) {
+            const char* tmp = std::getenv("TMPDIR");
+            base = tmp && *tmp ? tmp : "/tmp";
+        }
+        std::string path = base + "/dsd-cliques-XXXXXX";
+        std::vector<char> name(path.begin(), path.end());
+        name.push_back('\0');
+        fd = mkstemp(name.data());
+        if (fd >= 0) unlink(name.data());
+    }
+
+    ~SpillFile() {
+        if (mapping) munmap(mapping, length);
+        if (fd >= 0) close(fd);
+    }
+
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+
+    bool ok() const { return fd >= 0 && !failed; }
+    size_t size() const { return end; }
+
+    // Writes `bytes` at the end of the file; returns where, or -1.
+    long long append(const void* data, size_t bytes) {
+        if (!ok()) return -1;
+        size_t offset = end.fetch_add(bytes);
+        const char* p = static_cast<const char*>(data);
+        for (size_t done = 0; done < bytes;) {
+            ssize_t w = pwrite(fd, p + done, bytes - done, offset + done);
+            if (w <= 0) {
+                failed = true;
+                return -1;
+            }
+            done += w;
+        }
+        return offset;
+    }
+
+    bool read(size_t offset, void* data, size_t bytes) const {
+        char* p = static_cast<char*>(data);
+        for (size_t done = 0; done < bytes;) {
+            ssize_t r = pread(fd, p + done, bytes - done, offset + done);
+            if (r <= 0) return false;
+            done += r;
+        }
+        return true;
+    }
+
+    // Maps the whole file read-only, once no more appends will come; null on
+    // failure or for an empty file.
+    const void* map() {
+        if (mapping || !ok() || end == 0) return mapping;
+        length = end;
+        void* m = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (m == MAP_FAILED) return nullptr;
+        madvise(m, length, MADV_SEQUENTIAL);
+        mapping = m;
+        return mapping;
+    }
+
+    const void* data() const { return mapping; }
+
+    // Drops the mapped pages from the resident set; they are read back from
+    // the file on the next access.
+    void release() const {
+        if (mapping) madvise(mapping, length, MADV_DONTNEED);
+    }
+
+private:
+    int fd = -1;
+    std::atomic<size_t> end{0};
+    std::atomic<bool> failed{false};
+    void* mapping = nullptr;
+    size_t length = 0;
+};
+
+} // namespace dsd